@@ -31,6 +31,16 @@
 // Common WAIT value in milliseconds between commands
 #define TEMPO 0
 
+// Longest wait in milliseconds for the answer to a screen copy, which the
+// firmware may not support
+#define SCREENCOPY_TIMEOUT 20
+
+// Command stream recording (see uLCD_4DGL::record)
+#define REC_MAGIC   "ULCDREC1"  // file header
+#define REC_CHUNK   255         // most bytes in one chunk
+#define REC_START   0x01        // chunk flag: first chunk of a command
+#define REC_SLOW    0x02        // chunk flag: bytes were sent with writeBYTE
+
 // 4DGL SGE Function values for Goldelox Processor
 #define CLS          '\xD7'
 #define BAUDRATE     '\x0B' //null prefix
@@ -198,6 +208,15 @@ Example:
 * @endcode
 */
 
+/** Counters of the traffic to the screen, see uLCD_4DGL::stats */
+struct uLCD_Stats {
+    int bytes;      // bytes sent
+    int slow;       // of those, bytes sent with writeBYTE's delay
+    int commands;   // commands the screen answered
+    int naks;       // of those, commands it refused
+    int wait_us;    // time spent waiting for answers
+};
+
 class uLCD_4DGL : public Stream
 {
 
@@ -259,6 +278,8 @@ public :
     int  read_pixel(int, int);
     void pen_size(char);
     void BLIT(int x, int y, int w, int h, int *colors);
+    void BLIT565(int x, int y, int w, int h, const uint16_t *pixels);
+    int  screen_copy(int xs, int ys, int xd, int yd, int w, int h);
 
 // Text Commands
     void set_font(char);
@@ -290,6 +311,32 @@ public :
     void display_video(int, int);
     void display_frame(int, int, int);
 
+// Recording
+    /** Start recording every byte sent to the screen into an open file, or
+    * stop and flush the recording if f is NULL. The file holds REC_MAGIC,
+    * then chunks of up to REC_CHUNK bytes, each after a 6 byte header:
+    * the time of its first byte in us since recording began (32 bits,
+    * little endian), REC_* flags and its length. Time spent writing the
+    * file is not counted. tools/lcdreplay.py reads it on a PC.
+    * @param f File opened for writing, or NULL
+    */
+    void record(FILE *f);
+
+    /** Send a recording made by record() to the screen again, waiting for
+    * the screen's answer before each command.
+    * @param f File opened for reading
+    * @param paced If nonzero, bytes recorded as slow get writeBYTE's delay
+    * @param bytes If not NULL, set to the bytes sent
+    * @returns Commands sent, or -1 if f is not a recording
+    */
+    int  replay(FILE *f, int paced, int *bytes);
+
+// Profiling
+    /** Running totals of the traffic to the screen since it was created.
+    * Take the difference of two copies to measure a span, e.g. a frame.
+    */
+    uLCD_Stats stats;
+
 // Screen Data
     int type;
     int revision;
@@ -326,7 +373,7 @@ protected :
     void freeBUFFER  (void);
     void writeBYTE   (char);
     void writeBYTEfast   (char);
-    int  writeCOMMAND(char *, int);
+    int  writeCOMMAND(char *, int, int timeout_ms = 0);
     int  writeCOMMANDnull(char *, int);
     int  readVERSION (char *, int);
     int  getSTATUS   (char *, int);
@@ -334,6 +381,19 @@ protected :
 #if DEBUGMODE
     Serial pc;
 #endif // DEBUGMODE
+
+    int  waitANSWER  (int timeout_ms = 0);
+    Timer _wait_t;      // times waitANSWER
+
+    void recordBYTE  (char, int);
+    void recordFLUSH (void);
+    FILE  *_rec;        // recording file, NULL when not recording
+    char  *_rec_buf;    // chunk being recorded
+    int   _rec_len;     // bytes in it
+    int   _rec_flags;   // its REC_* flags
+    int   _rec_us;      // time of its first byte
+    int   _rec_start;   // next chunk starts a command
+    Timer _rec_t;       // time since recording began
 };
 
 typedef unsigned char BYTE;
@@ -223,6 +223,7 @@ void uLCD_4DGL :: pixel(int x, int y, int color)     // draw a pixel
 void uLCD_4DGL :: BLIT(int x, int y, int w, int h, int *colors)     // draw a block of pixels
 {
     int red5, green6, blue5;
+    freeBUFFER();
     writeBYTEfast('\x00');
     writeBYTEfast(BLITCOM);
     writeBYTEfast((x >> 8) & 0xFF);
@@ -242,13 +243,14 @@ void uLCD_4DGL :: BLIT(int x, int y, int w, int h, int *colors)     // draw a bl
         writeBYTEfast(((green6 << 5) + (blue5 >> 0)) & 0xFF);  // second part of 16 bits color
     }
     int resp=0;
-    while (!_cmd.readable()) wait_ms(TEMPO);              // wait for screen answer
+    waitANSWER();                                     // wait for screen answer
     if (_cmd.readable()) resp = _cmd.getc();           // read response if any
     switch (resp) {
         case ACK :                                     // if OK return   1
             resp =  1;
             break;
         case NAK :                                     // if NOK return -1
+            stats.naks++;
             resp = -1;
             break;
         default :
@@ -259,6 +261,66 @@ void uLCD_4DGL :: BLIT(int x, int y, int w, int h, int *colors)     // draw a bl
     pc.printf("   Answer received : %d\n",resp);
 #endif
 
+}
+//******************************************************************************************************
+void uLCD_4DGL :: BLIT565(int x, int y, int w, int h, const uint16_t *pixels)     // draw a block of RGB565 pixels
+{
+    // Same command as BLIT, but the pixels are already packed. The header
+    // keeps BLIT's slow bytes and pause before the pixels until a board
+    // shows the LCD keeps up without them.
+    freeBUFFER();
+    writeBYTEfast('\x00');
+    writeBYTEfast(BLITCOM);
+    writeBYTEfast((x >> 8) & 0xFF);
+    writeBYTEfast(x & 0xFF);
+    writeBYTEfast((y >> 8) & 0xFF);
+    writeBYTEfast(y & 0xFF);
+    writeBYTEfast((w >> 8) & 0xFF);
+    writeBYTE(w & 0xFF);
+    writeBYTE((h >> 8) & 0xFF);
+    writeBYTE(h & 0xFF);
+    wait_ms(1);
+    for (int i=0; i<w*h; i++) {
+        writeBYTEfast(pixels[i] >> 8);                 // first part of 16 bits color
+        writeBYTEfast(pixels[i] & 0xFF);               // second part of 16 bits color
+    }
+    int resp=0;
+    waitANSWER();                                  // wait for screen answer
+    if (_cmd.readable()) resp = _cmd.getc();           // read response if any
+    if (resp == NAK) stats.naks++;
+#if DEBUGMODE
+    pc.printf("   Answer received : %d\n",resp == ACK ? 1 : resp == NAK ? -1 : 0);
+#endif
+}
+//******************************************************************************************************
+int uLCD_4DGL :: screen_copy(int xs, int ys, int xd, int yd, int w, int h)     // copy a block of the screen
+{
+    // Copies the w x h block at (xs,ys) to (xd,yd) on the display itself.
+    // Returns 1 on ACK, so callers can fall back to redrawing if the
+    // firmware does not support it; waits SCREENCOPY_TIMEOUT at most.
+    char command[13]= "";
+
+    command[0] = SCREENCOPY;
+
+    command[1] = (xs >> 8) & 0xFF;
+    command[2] = xs & 0xFF;
+
+    command[3] = (ys >> 8) & 0xFF;
+    command[4] = ys & 0xFF;
+
+    command[5] = (xd >> 8) & 0xFF;
+    command[6] = xd & 0xFF;
+
+    command[7] = (yd >> 8) & 0xFF;
+    command[8] = yd & 0xFF;
+
+    command[9] = (w >> 8) & 0xFF;
+    command[10] = w & 0xFF;
+
+    command[11] = (h >> 8) & 0xFF;
+    command[12] = h & 0xFF;
+
+    return writeCOMMAND(command, 13, SCREENCOPY_TIMEOUT);
 }
 //******************************************************************************************************
 int uLCD_4DGL :: read_pixel(int x, int y)   // read screen info and populate data
@@ -283,7 +345,7 @@ int uLCD_4DGL :: read_pixel(int x, int y)   // read screen info and populate dat
         writeBYTE(command[i]);
     }
 
-    while (!_cmd.readable()) wait_ms(TEMPO);    // wait a bit for screen answer
+    waitANSWER();                           // wait a bit for screen answer
 
     while ( resp < ARRAY_SIZE(response)) {   //read ack and 16-bit color response
         temp = _cmd.getc();
@@ -30,7 +30,7 @@ int uLCD_4DGL :: media_init()
     char command[1] = "";
     command[0] = MINIT;
     writeCOMMAND(command, 1);
-    while (!_cmd.readable()) wait_ms(TEMPO);              // wait for screen answer
+    waitANSWER();                                     // wait for screen answer
     if (_cmd.readable()) {
         resp = _cmd.getc();           // read response
         resp = resp << 8 + _cmd.getc();
@@ -74,7 +74,7 @@ char uLCD_4DGL :: read_byte()
     char command[1] = "";
     command[0] = READBYTE;
     writeCOMMAND(command, 1);
-    while (!_cmd.readable()) wait_ms(TEMPO);              // wait for screen answer
+    waitANSWER();                                     // wait for screen answer
     if (_cmd.readable()) {
         resp = _cmd.getc();           // read response
         resp = _cmd.getc();
@@ -89,7 +89,7 @@ int  uLCD_4DGL :: read_word()
     char command[1] = "";
     command[0] = READWORD;
     writeCOMMAND(command, 1);
-    while (!_cmd.readable()) wait_ms(TEMPO);              // wait for screen answer
+    waitANSWER();                                     // wait for screen answer
     if (_cmd.readable()) {
         resp = _cmd.getc();           // read response
         resp = resp << 8 + _cmd.getc();
@@ -43,6 +43,8 @@ uLCD_4DGL :: uLCD_4DGL(PinName tx, PinName rx, PinName rst) : _cmd(tx, rx),
     pc.printf("*********************\n");
 #endif
 
+    _rec = NULL;  // not recording
+    memset(&stats, 0, sizeof(stats));
     _rst = 1;    // put RESET pin to high to start TFT screen
     reset();
     cls();       // clear screen
@@ -60,6 +62,9 @@ uLCD_4DGL :: uLCD_4DGL(PinName tx, PinName rx, PinName rst) : _cmd(tx, rx),
 void uLCD_4DGL :: writeBYTE(char c)   // send a BYTE command to screen
 {
 
+    if (_rec) recordBYTE(c, REC_SLOW);
+    stats.bytes++;
+    stats.slow++;
     _cmd.putc(c);
     wait_us(500);  //mbed is too fast for LCD at high baud rates in some long commands
 
@@ -73,6 +78,8 @@ void uLCD_4DGL :: writeBYTE(char c)   // send a BYTE command to screen
 void uLCD_4DGL :: writeBYTEfast(char c)   // send a BYTE command to screen
 {
 
+    if (_rec) recordBYTE(c, 0);
+    stats.bytes++;
     _cmd.putc(c);
     //wait_ms(0.0);  //mbed is too fast for LCD at high baud rates - but not in short commands
 
@@ -86,10 +93,104 @@ void uLCD_4DGL :: freeBUFFER(void)         // Clear serial buffer before writing
 {
 
     while (_cmd.readable()) _cmd.getc();  // clear buffer garbage
+    if (_rec) {                           // a command starts here
+        recordFLUSH();
+        _rec_start = 1;
+    }
+}
+
+//******************************************************************************************************
+int uLCD_4DGL :: waitANSWER(int timeout_ms)   // wait for the screen to answer a command, forever if timeout_ms is 0
+{
+    _wait_t.reset();
+    _wait_t.start();
+    while (!_cmd.readable()) {
+        if (timeout_ms && _wait_t.read_ms() >= timeout_ms) break;  // gave up, a late answer is cleared by freeBUFFER
+        wait_ms(TEMPO);
+    }
+    _wait_t.stop();
+    stats.wait_us += _wait_t.read_us();
+    stats.commands++;
+    return _cmd.readable();
+}
+
+//******************************************************************************************************
+void uLCD_4DGL :: recordBYTE(char c, int slow)   // add a sent BYTE to the recording
+{
+    if (_rec_len && (_rec_len == REC_CHUNK || (_rec_flags & REC_SLOW) != slow)) recordFLUSH();
+    if (_rec_len == 0) {
+        _rec_us = _rec_t.read_us();
+        _rec_flags = slow | (_rec_start ? REC_START : 0);
+        _rec_start = 0;
+    }
+    _rec_buf[_rec_len++] = c;
+}
+
+//******************************************************************************************************
+void uLCD_4DGL :: recordFLUSH(void)   // write the recorded chunk to the file
+{
+    if (_rec_len == 0) return;
+    _rec_t.stop();                    // file time is not screen time
+    char head[6];
+    for (int i = 0; i < 4; i++) head[i] = (_rec_us >> (8 * i)) & 0xFF;
+    head[4] = _rec_flags;
+    head[5] = _rec_len;
+    fwrite(head, 1, sizeof(head), _rec);
+    fwrite(_rec_buf, 1, _rec_len, _rec);
+    _rec_len = 0;
+    _rec_t.start();
+}
+
+//******************************************************************************************************
+void uLCD_4DGL :: record(FILE *f)   // start or stop recording the command stream
+{
+    if (_rec) {                       // stop the one in progress
+        recordFLUSH();
+        free(_rec_buf);
+        _rec = NULL;
+    }
+    if (f == NULL) return;
+    _rec_buf = (char *) malloc(REC_CHUNK);
+    if (_rec_buf == NULL) return;
+    fwrite(REC_MAGIC, 1, strlen(REC_MAGIC), f);
+    _rec_len = 0;
+    _rec_start = 1;
+    _rec_t.reset();
+    _rec_t.start();
+    _rec = f;
+}
+
+//******************************************************************************************************
+int uLCD_4DGL :: replay(FILE *f, int paced, int *bytes)   // send a recording to the screen again
+{
+    char magic[8], head[6], data[REC_CHUNK];
+    int commands = 0, sent = 0;
+    if (fread(magic, 1, 8, f) != 8 || memcmp(magic, REC_MAGIC, 8)) return -1;
+    while (fread(head, 1, sizeof(head), f) == sizeof(head)) {
+        int len = (unsigned char) head[5];
+        if ((int) fread(data, 1, len, f) != len) break;
+        if (head[4] & REC_START) {
+            if (commands++) {         // wait for the answer to the last one
+                for (int i = 0; !_cmd.readable() && i < 25000; i++) wait_us(20);
+            }
+            while (_cmd.readable()) _cmd.getc();
+        }
+        for (int i = 0; i < len; i++) {
+            if (paced && (head[4] & REC_SLOW))
+                writeBYTE(data[i]);
+            else
+                writeBYTEfast(data[i]);
+        }
+        sent += len;
+    }
+    for (int i = 0; commands && !_cmd.readable() && i < 25000; i++) wait_us(20);
+    while (_cmd.readable()) _cmd.getc();
+    if (bytes) *bytes = sent;
+    return commands;
 }
 
 //******************************************************************************************************
-int uLCD_4DGL :: writeCOMMAND(char *command, int number)   // send several BYTES making a command and return an answer
+int uLCD_4DGL :: writeCOMMAND(char *command, int number, int timeout_ms)   // send several BYTES making a command and return an answer
 {
 
 #if DEBUGMODE
@@ -105,13 +206,14 @@ int uLCD_4DGL :: writeCOMMAND(char *command, int number)   // send several BYTES
         else
             writeBYTE(command[i]); // send command to serial port but slower
     }
-    while (!_cmd.readable()) wait_ms(TEMPO);              // wait for screen answer
+    waitANSWER(timeout_ms);                           // wait for screen answer
     if (_cmd.readable()) resp = _cmd.getc();           // read response if any
     switch (resp) {
         case ACK :                                     // if OK return   1
             resp =  1;
             break;
         case NAK :                                     // if NOK return -1
+            stats.naks++;
             resp = -1;
             break;
         default :
@@ -153,13 +255,14 @@ int uLCD_4DGL :: writeCOMMANDnull(char *command, int number)   // send several B
         else
             writeBYTE(command[i]); // send command to serial port with delay
     }
-    while (!_cmd.readable()) wait_ms(TEMPO);              // wait for screen answer
+    waitANSWER();                                     // wait for screen answer
     if (_cmd.readable()) resp = _cmd.getc();           // read response if any
     switch (resp) {
         case ACK :                                     // if OK return   1
             resp =  1;
             break;
         case NAK :                                     // if NOK return -1
+            stats.naks++;
             resp = -1;
             break;
         default :
@@ -308,6 +411,7 @@ void uLCD_4DGL :: baudrate(int speed)    // set screen baud rate
             resp =  1;
             break;
         case NAK :                                     // if NOK return -1
+            stats.naks++;
             resp = -1;
             break;
         default :
@@ -327,7 +431,7 @@ int uLCD_4DGL :: readVERSION(char *command, int number)   // read screen info an
 
     for (i = 0; i < number; i++) writeBYTE(command[i]);    // send all chars to serial port
 
-    while (!_cmd.readable()) wait_ms(TEMPO);               // wait for screen answer
+    waitANSWER();                                      // wait for screen answer
 
     while (_cmd.readable() && resp < ARRAY_SIZE(response)) {
         temp = _cmd.getc();
@@ -445,7 +549,7 @@ int uLCD_4DGL :: getSTATUS(char *command, int number)   // read screen info and
 
     for (i = 0; i < number; i++) writeBYTE(command[i]);    // send all chars to serial port
 
-    while (!_cmd.readable()) wait_ms(TEMPO);    // wait for screen answer
+    waitANSWER();                           // wait for screen answer
 
     while (_cmd.readable() && resp < ARRAY_SIZE(response)) {
         temp = _cmd.getc();
@@ -0,0 +1,147 @@
+//=================================================================
+// The debug console class file.
+//
+// Copyright 2023 Georgia Tech. All rights reserved.
+// The materials provided by the instructor in this course are for
+// the use of the students currently enrolled in the course.
+// Copyrighted course materials may not be further disseminated.
+// This file must NOT be made publicly available anywhere.
+//==================================================================
+
+#include "console.h"
+#include "globals.h"
+#include "map.h"
+#include "memory.h"
+#include "graphics.h"
+#include "frame.h"
+
+static char line[CONSOLE_LINE + 1];  // Command being typed
+static int line_len;                 // Characters in line
+static FILE* rec;                    // LCD recording in progress, see rec
+
+void draw_game(int init);
+
+/**
+ * A map dump in progress: the region still to print.
+ */
+static struct {
+    int x, w;       // Columns
+    int y, y_end;   // Next row and one past the last
+} dump;
+
+/**
+ * Starts a dump of the given region of the active map.
+ */
+static void start_dump(int x, int y, int w, int h)
+{
+    if (w <= 0 || h <= 0) {
+        pc.printf("bad region\r\n");
+        return;
+    }
+    pc.printf("map %d (%dx%d) x %d..%d y %d..%d\r\n", get_active_map_index(),
+              map_width(), map_height(), x, x + w - 1, y, y + h - 1);
+    dump.x = x;
+    dump.w = w;
+    dump.y = y;
+    dump.y_end = y + h < map_height() ? y + h : map_height();
+}
+
+/**
+ * Starts recording the LCD command stream, or stops the recording.
+ */
+static void toggle_recording()
+{
+    if (rec) {
+        uLCD.record(NULL);
+        fclose(rec);
+        rec = NULL;
+        pc.printf("recording saved to %s\r\n", CONSOLE_REC_PATH);
+        return;
+    }
+    rec = fopen(CONSOLE_REC_PATH, "wb");
+    if (!rec) {
+        pc.printf("cannot open %s\r\n", CONSOLE_REC_PATH);
+        return;
+    }
+    uLCD.record(rec);
+    pc.printf("recording\r\n");
+}
+
+/**
+ * Sends the recording to the LCD again and prints how long it took.
+ */
+static void play_recording(int paced)
+{
+    if (rec) toggle_recording(); // can't play what is still being written
+    FILE* f = fopen(CONSOLE_REC_PATH, "rb");
+    if (!f) {
+        pc.printf("cannot open %s\r\n", CONSOLE_REC_PATH);
+        return;
+    }
+    int bytes;
+    Timer t;
+    t.start();
+    int commands = uLCD.replay(f, paced, &bytes);
+    int ms = t.read_ms();
+    fclose(f);
+    if (commands < 0) {
+        pc.printf("%s is not a recording\r\n", CONSOLE_REC_PATH);
+        return;
+    }
+    pc.printf("replayed %d commands, %d bytes in %d ms\r\n", commands, bytes, ms);
+    draw_game(true); // put the game back on the screen
+}
+
+/**
+ * Runs one complete command line.
+ */
+static void run_command(char* cmd)
+{
+    int x, y, w, h, ms;
+    if (!strcmp(cmd, "help")) {
+        pc.printf("help | map [x y w h] | mem | blit | fps [ms] | lcd | rec | play [fast]\r\n");
+    } else if (!strcmp(cmd, "map")) {
+        start_dump(0, 0, map_width(), map_height());
+    } else if (sscanf(cmd, "map %d %d %d %d", &x, &y, &w, &h) == 4) {
+        start_dump(x, y, w, h);
+    } else if (!strcmp(cmd, "mem")) {
+        mem_report();
+    } else if (!strcmp(cmd, "blit")) {
+        blit_benchmark();
+    } else if (!strcmp(cmd, "fps")) {
+        frame_report();
+    } else if (sscanf(cmd, "fps %d", &ms) == 1 && ms > 0) {
+        frame_set_budget(ms);
+    } else if (!strcmp(cmd, "lcd")) {
+        frame_lcd_report();
+    } else if (!strcmp(cmd, "rec")) {
+        toggle_recording();
+    } else if (!strcmp(cmd, "play")) {
+        play_recording(true);
+    } else if (!strcmp(cmd, "play fast")) {
+        play_recording(false);
+    } else if (cmd[0]) {
+        pc.printf("unknown command: %s\r\n", cmd);
+    }
+}
+
+void console_poll()
+{
+    while (pc.readable()) {
+        char c = pc.getc();
+        if (c == '\r' || c == '\n') {
+            line[line_len] = 0;
+            line_len = 0;
+            run_command(line);
+        } else if (line_len < CONSOLE_LINE) {
+            line[line_len++] = c;
+        }
+    }
+
+    if (dump.y < dump.y_end) { // continue a dump a few rows at a time
+        int rows = dump.y_end - dump.y;
+        if (rows > CONSOLE_ROWS_PER_POLL) rows = CONSOLE_ROWS_PER_POLL;
+        map_dump(dump.x, dump.y, dump.w, rows);
+        dump.y += rows;
+    }
+}
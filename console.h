@@ -0,0 +1,47 @@
+//=================================================================
+// The debug console header file.
+//
+// Copyright 2023 Georgia Tech. All rights reserved.
+// The materials provided by the instructor in this course are for
+// the use of the students currently enrolled in the course.
+// Copyrighted course materials may not be further disseminated.
+// This file must NOT be made publicly available anywhere.
+//==================================================================
+
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+/*
+A line-based debug console on the pc serial port. console_poll() is called
+once per game frame; it only reads characters that have already arrived, so
+it never blocks, and long output such as a map dump is spread over frames a
+few rows at a time. Commands:
+  help                 list the commands
+  map [x y w h]        dump the active map, or a region of it (see map_dump)
+  mem                  print the memory report (see mem_report)
+  blit                 time tile and text drawing (see blit_benchmark)
+  fps [ms]             print frame timing (see frame_report), or set the
+                       frame budget
+  lcd                  print the LCD traffic per frame (see frame_lcd_report)
+  rec                  start or stop recording what is sent to the LCD
+                       into CONSOLE_REC_PATH (see uLCD_4DGL::record)
+  play [fast]          send the recording to the LCD again and time it;
+                       fast sends every byte without writeBYTE's delay
+*/
+
+// Longest command line; extra characters are dropped
+#define CONSOLE_LINE 40
+
+// Map rows a dump prints per console_poll
+#define CONSOLE_ROWS_PER_POLL 4
+
+// File the rec command records the LCD command stream into
+#define CONSOLE_REC_PATH "/local/LCD.REC"
+
+/**
+ * Reads pending console input, runs any complete command and continues any
+ * unfinished output. Call once per game frame.
+ */
+void console_poll();
+
+#endif // CONSOLE_H
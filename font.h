@@ -0,0 +1,40 @@
+//=================================================================
+// The font header file.
+//
+// Copyright 2023 Georgia Tech. All rights reserved.
+// The materials provided by the instructor in this course are for
+// the use of the students currently enrolled in the course.
+// Copyrighted course materials may not be further disseminated.
+// This file must NOT be made publicly available anywhere.
+//==================================================================
+
+#ifndef FONT_H
+#define FONT_H
+
+#include <stdint.h>
+
+/*
+A 5x7 bitmap font for the printable ASCII characters, drawn in software by
+draw_text (see graphics.h) instead of by the LCD's own text commands.
+*/
+
+// Glyph size in pixels
+#define GLYPH_W 5
+#define GLYPH_H 7
+
+// Space a character takes in a line of text, gaps included
+#define GLYPH_ADVANCE 6
+#define GLYPH_LINE    8
+
+// Characters in the font: ' ' to '~'
+#define GLYPH_FIRST ' '
+#define GLYPH_LAST  '~'
+#define GLYPH_COUNT (GLYPH_LAST - GLYPH_FIRST + 1)
+
+/**
+ * Glyph bitmaps, one byte per column from left to right. Bit 0 of each byte
+ * is the top pixel.
+ */
+extern const uint8_t GLYPHS[GLYPH_COUNT][GLYPH_W];
+
+#endif // FONT_H
@@ -0,0 +1,182 @@
+//=================================================================
+// The field of view class file.
+//
+// Copyright 2023 Georgia Tech. All rights reserved.
+// The materials provided by the instructor in this course are for
+// the use of the students currently enrolled in the course.
+// Copyrighted course materials may not be further disseminated.
+// This file must NOT be made publicly available anywhere.
+//==================================================================
+
+#include "fov.h"
+#include "globals.h"
+#include "map.h"
+
+// Side of the square of tiles a field of view covers
+#define FOV_SIZE (2*FOV_RADIUS + 1)
+
+/**
+ * One computed field of view.
+ */
+struct FovGrid {
+    int map;              // Map it was computed on, -1 if none
+    int fog;              // Zero if everything counts as visible
+    int ox, oy;           // Player tile it was computed from
+    unsigned char seen[FOV_SIZE][FOV_SIZE]; // [dy][dx] around (ox,oy)
+};
+
+/**
+ * A row of tiles being scanned in one quadrant, and the slopes bounding the
+ * part of it that light can reach. Slopes are fractions num/den, den > 0.
+ */
+struct FovRow {
+    int depth;            // Distance from the player along the quadrant axis
+    int start_num, start_den;
+    int end_num, end_den;
+};
+
+static FovGrid view;            // The cached field of view
+static int stale = true;        // Map changed since view was computed
+static unsigned fog_maps;       // Bit per map index with fog of war
+
+///////////////////////
+// Shadowcasting
+///////////////////////
+
+/**
+ * Floor of a/b for b > 0, rounding towards minus infinity.
+ */
+static int floor_div(int a, int b)
+{
+    return a >= 0 ? a / b : -((-a + b - 1) / b);
+}
+
+/**
+ * Maps a (row, col) position in quadrant q to map coordinates.
+ */
+static void quadrant_xy(int q, int row, int col, int* x, int* y)
+{
+    switch (q) {
+        case 0: *x = view.ox + col; *y = view.oy - row; break; // north
+        case 1: *x = view.ox + row; *y = view.oy + col; break; // east
+        case 2: *x = view.ox + col; *y = view.oy + row; break; // south
+        default: *x = view.ox - row; *y = view.oy + col; break; // west
+    }
+}
+
+/**
+ * Marks (x,y) visible in the current grid.
+ */
+static void reveal(int x, int y)
+{
+    view.seen[y - view.oy + FOV_RADIUS][x - view.ox + FOV_RADIUS] = true;
+}
+
+/**
+ * Scans one row of quadrant q and recurses into the rows behind it, keeping
+ * to the part that is not in shadow.
+ */
+static void scan(int q, FovRow row)
+{
+    if (row.depth > FOV_RADIUS) return;
+    // Columns from round-half-up(depth*start) to round-half-down(depth*end)
+    int min_col = floor_div(2 * row.depth * row.start_num + row.start_den, 2 * row.start_den);
+    int max_col = -floor_div(-(2 * row.depth * row.end_num - row.end_den), 2 * row.end_den);
+    int prev_wall = -1; // -1 before the first tile, then whether it was a wall
+    for (int col = min_col; col <= max_col; col++)
+    {
+        int x, y;
+        quadrant_xy(q, row.depth, col, &x, &y);
+        int wall = map_opaque(x, y);
+        // Floors are lit only if in view symmetrically; walls always are
+        if (wall || (col * row.start_den >= row.depth * row.start_num &&
+                     col * row.end_den <= row.depth * row.end_num))
+            reveal(x, y);
+        if (prev_wall == 1 && !wall) { // light resumes after a wall
+            row.start_num = 2 * col - 1;
+            row.start_den = 2 * row.depth;
+        }
+        if (prev_wall == 0 && wall) { // a wall starts a shadow
+            FovRow next = row;
+            next.depth++;
+            next.end_num = 2 * col - 1;
+            next.end_den = 2 * row.depth;
+            scan(q, next);
+        }
+        prev_wall = wall;
+    }
+    if (prev_wall == 0) {
+        row.depth++;
+        scan(q, row);
+    }
+}
+
+/**
+ * Computes the current grid from scratch for (ox,oy).
+ */
+static void compute()
+{
+    memset(view.seen, 0, sizeof(view.seen));
+    if (!view.fog) return;
+    reveal(view.ox, view.oy);
+    for (int q = 0; q < 4; q++) {
+        FovRow first = {1, -1, 1, 1, 1};
+        scan(q, first);
+    }
+}
+
+/**
+ * Returns whether (x,y) is visible in grid g.
+ */
+static int grid_visible(FovGrid* g, int x, int y)
+{
+    if (!g->fog) return true;
+    int dx = x - g->ox + FOV_RADIUS;
+    int dy = y - g->oy + FOV_RADIUS;
+    if (dx < 0 || dy < 0 || dx >= FOV_SIZE || dy >= FOV_SIZE) return false;
+    return g->seen[dy][dx];
+}
+
+/**
+ * Map change listener: a change on the map in view may open or block sight.
+ */
+static void fov_map_changed(int m, int, int)
+{
+    if (m == view.map) stale = true;
+}
+
+///////////////////////
+// Public functions
+///////////////////////
+
+void fov_init()
+{
+    view.map = -1;
+    stale = true;
+    map_on_change(fov_map_changed);
+}
+
+void fov_set_fog(int m, int on)
+{
+    if (on) fog_maps |= 1u << m;
+    else fog_maps &= ~(1u << m);
+    if (m == view.map) stale = true;
+}
+
+int fov_update(int x, int y)
+{
+    int m = get_active_map_index();
+    if (!stale && view.map == m && view.ox == x && view.oy == y) return false;
+    view.map = m;
+    view.fog = (fog_maps >> m) & 1;
+    view.ox = x;
+    view.oy = y;
+    compute();
+    stale = false;
+    return true;
+}
+
+int fov_visible(int x, int y)
+{
+    return grid_visible(&view, x, y);
+}
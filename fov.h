@@ -0,0 +1,51 @@
+//=================================================================
+// The field of view header file.
+//
+// Copyright 2023 Georgia Tech. All rights reserved.
+// The materials provided by the instructor in this course are for
+// the use of the students currently enrolled in the course.
+// Copyrighted course materials may not be further disseminated.
+// This file must NOT be made publicly available anywhere.
+//==================================================================
+
+#ifndef FOV_H
+#define FOV_H
+
+/*
+Line of sight from the player, for fog of war on dark maps such as caves.
+Visibility is computed by symmetric shadowcasting over map_opaque(): a tile
+is visible from the player exactly when the player is visible from it, and
+walls bounding a visible area are lit too.
+
+The result is cached for the player's tile and only recomputed when the
+player moves or the map changes.
+*/
+
+// How far the player sees, in tiles; enough to cover the viewport
+#define FOV_RADIUS 5
+
+/**
+ * Initializes the module and hooks it up to map changes. Call once after
+ * maps_init().
+ */
+void fov_init();
+
+/**
+ * Turns fog of war on or off for map m. Maps start without fog, and on those
+ * every tile counts as visible.
+ */
+void fov_set_fog(int m, int on);
+
+/**
+ * Brings the cached field of view up to date for a player at (x,y) on the
+ * active map. Call once per frame before drawing. Returns nonzero if it was
+ * recomputed.
+ */
+int fov_update(int x, int y);
+
+/**
+ * Returns nonzero if (x,y) is visible in the current field of view.
+ */
+int fov_visible(int x, int y);
+
+#endif // FOV_H
@@ -0,0 +1,155 @@
+//=================================================================
+// The frame scheduler class file.
+//
+// Copyright 2023 Georgia Tech. All rights reserved.
+// The materials provided by the instructor in this course are for
+// the use of the students currently enrolled in the course.
+// Copyrighted course materials may not be further disseminated.
+// This file must NOT be made publicly available anywhere.
+//==================================================================
+
+#include "frame.h"
+#include "globals.h"
+#include "map.h"
+
+static int budget_us = FRAME_BUDGET_MS * 1000; // See frame_set_budget
+static int changed = true;  // Something changed since the last drawn frame
+static Timer work;          // Time since frame_start
+static Timer period;        // Time since the report period began
+
+/**
+ * Counts since the report period began.
+ */
+static struct {
+    int frames;     // Frames ended
+    int drawn;      // Frames that were drawn
+    int over;       // Frames whose work took longer than the budget
+    double work_us; // Work time, summed
+    int worst_us;   // Longest work time
+} stats;
+
+static uLCD_Stats lcd_start;                 // uLCD.stats at frame_start
+static uLCD_Stats lcd_frames[FRAME_HISTORY]; // Traffic of recent frames, a ring
+static int lcd_next;                         // Slot the next frame goes in
+static int lcd_count;                        // Slots in use
+
+/**
+ * Map change listener: whatever changed may be on screen.
+ */
+static void frame_map_changed(int, int, int)
+{
+    changed = true;
+}
+
+void frame_init()
+{
+    map_on_change(frame_map_changed);
+    memset(&stats, 0, sizeof(stats));
+    period.start();
+}
+
+void frame_set_budget(int ms)
+{
+    budget_us = ms * 1000;
+}
+
+void frame_start()
+{
+    work.reset();
+    work.start();
+    lcd_start = uLCD.stats;
+}
+
+void frame_changed()
+{
+    changed = true;
+}
+
+int frame_render_due()
+{
+    if (!changed) return false;
+    changed = false;
+    stats.drawn++;
+    return true;
+}
+
+void frame_end()
+{
+    uLCD_Stats* lcd = &lcd_frames[lcd_next];
+    lcd->bytes = uLCD.stats.bytes - lcd_start.bytes;
+    lcd->slow = uLCD.stats.slow - lcd_start.slow;
+    lcd->commands = uLCD.stats.commands - lcd_start.commands;
+    lcd->naks = uLCD.stats.naks - lcd_start.naks;
+    lcd->wait_us = uLCD.stats.wait_us - lcd_start.wait_us;
+    lcd_next = (lcd_next + 1) % FRAME_HISTORY;
+    if (lcd_count < FRAME_HISTORY) lcd_count++;
+
+    int us = work.read_us();
+    stats.frames++;
+    stats.work_us += us;
+    if (us > stats.worst_us) stats.worst_us = us;
+    if (us > budget_us) stats.over++;
+    if (us < budget_us) wait_us(budget_us - us);
+}
+
+void frame_report()
+{
+    int ms = period.read_ms();
+    if (ms == 0) ms = 1;
+    int avg_us = stats.frames ? (int) (stats.work_us / stats.frames) : 0;
+    int fps10 = (int) (stats.frames * 10000.0 / ms); // tenths
+    pc.printf("frames: %d in %d ms, %d.%d fps, %d drawn, %d skipped\r\n",
+              stats.frames, ms, fps10 / 10, fps10 % 10,
+              stats.drawn, stats.frames - stats.drawn);
+    pc.printf("work: avg %d us, worst %d us, budget %d us, slack %d us, %d over\r\n",
+              avg_us, stats.worst_us, budget_us, budget_us - avg_us, stats.over);
+    memset(&stats, 0, sizeof(stats));
+    period.reset();
+}
+
+void frame_lcd(uLCD_Stats* out)
+{
+    *out = lcd_frames[(lcd_next + FRAME_HISTORY - 1) % FRAME_HISTORY];
+}
+
+/**
+ * Adds one frame's count to a sum and keeps the worst.
+ */
+static void tally(int n, int* sum, int* worst)
+{
+    *sum += n;
+    if (n > *worst) *worst = n;
+}
+
+/**
+ * Prints the average, worst and total of one LCD counter over the kept
+ * frames.
+ */
+static void print_lcd_counter(const char* name, int sum, int worst)
+{
+    pc.printf("  %-9s avg %6d  worst %6d  total %8d\r\n",
+              name, lcd_count ? sum / lcd_count : 0, worst, sum);
+}
+
+void frame_lcd_report()
+{
+    uLCD_Stats sum, worst;
+    memset(&sum, 0, sizeof(sum));
+    memset(&worst, 0, sizeof(worst));
+    int busy = 0; // frames that sent anything
+    for (int i = 0; i < lcd_count; i++) {
+        uLCD_Stats* f = &lcd_frames[i];
+        tally(f->bytes, &sum.bytes, &worst.bytes);
+        tally(f->slow, &sum.slow, &worst.slow);
+        tally(f->commands, &sum.commands, &worst.commands);
+        tally(f->wait_us, &sum.wait_us, &worst.wait_us);
+        tally(f->naks, &sum.naks, &worst.naks);
+        if (f->bytes) busy++;
+    }
+    pc.printf("lcd per frame, last %d frames (%d sent something):\r\n", lcd_count, busy);
+    print_lcd_counter("bytes", sum.bytes, worst.bytes);
+    print_lcd_counter("slow", sum.slow, worst.slow);
+    print_lcd_counter("commands", sum.commands, worst.commands);
+    print_lcd_counter("wait us", sum.wait_us, worst.wait_us);
+    print_lcd_counter("naks", sum.naks, worst.naks);
+}
@@ -0,0 +1,86 @@
+//=================================================================
+// The frame scheduler header file.
+//
+// Copyright 2023 Georgia Tech. All rights reserved.
+// The materials provided by the instructor in this course are for
+// the use of the students currently enrolled in the course.
+// Copyrighted course materials may not be further disseminated.
+// This file must NOT be made publicly available anywhere.
+//==================================================================
+
+#ifndef FRAME_H
+#define FRAME_H
+
+/*
+Paces the game loop and decides which frames need drawing. Each frame runs
+between frame_start() and frame_end(), which waits out whatever is left of
+the frame budget. Anything that changes what is on screen calls
+frame_changed(); map changes are noticed on their own. Frames where nothing
+changed skip drawing entirely. The time each frame's work takes is measured
+against the budget, and frame_report() prints the rate and slack, so the
+budget can be lowered when there is room.
+
+The traffic each frame sends to the LCD (see uLCD_4DGL::stats) is kept for
+the last FRAME_HISTORY frames, and frame_lcd_report() summarizes it.
+*/
+
+#include "uLCD_4DGL.h"
+
+// Default frame budget in milliseconds
+#define FRAME_BUDGET_MS 100
+
+// Frames whose LCD traffic is kept for frame_lcd_report
+#define FRAME_HISTORY 32
+
+/**
+ * Initializes the scheduler and hooks it up to map changes. Call once after
+ * maps_init().
+ */
+void frame_init();
+
+/**
+ * Sets the frame budget in milliseconds.
+ */
+void frame_set_budget(int ms);
+
+/**
+ * Marks the start of a frame's work.
+ */
+void frame_start();
+
+/**
+ * Records that something on screen may have changed this frame.
+ */
+void frame_changed();
+
+/**
+ * Returns nonzero if anything changed since the last frame that was drawn,
+ * and counts this frame as drawn. Returns zero for an idle frame.
+ */
+int frame_render_due();
+
+/**
+ * Marks the end of a frame's work, then waits out the rest of the budget.
+ */
+void frame_end();
+
+/**
+ * Prints over pc the frame rate achieved, the frames drawn and skipped, and
+ * the work time and slack per frame since the last report, then starts a
+ * new report period.
+ */
+void frame_report();
+
+/**
+ * Copies into out the traffic to the LCD during the last frame that ended.
+ */
+void frame_lcd(uLCD_Stats* out);
+
+/**
+ * Prints over pc the average and worst LCD traffic per frame over the last
+ * FRAME_HISTORY frames: bytes, slow bytes, commands, time waiting for the
+ * LCD to answer, and refused commands.
+ */
+void frame_lcd_report();
+
+#endif // FRAME_H
@@ -52,10 +52,23 @@ extern Nav_Switch navs;     // Nav Switch
 /////////////////////////////////////////
 
 #define F_DEBUG   1                     // Debug flag
+// #define F_SCROLL  1                  // Scroll the view with the LCD's screen
+                                        // copy; unconfirmed on this firmware
 #define BACKGROUND_COLOR 0x000000       // Black Background
 #define LANDSCAPE_HEIGHT 4              // Number of pixel on the screen
 #define MAX_BUILDING_HEIGHT 10          // Number of pixel on the screen
 
+// The LPC1768 has two 16 KB AHB SRAM banks that the mbed runtime leaves
+// unused. Big static buffers can be placed there to spare main RAM:
+//     static uint16_t buf[N] AHBSRAM0;
+#if defined(TARGET_LPC1768)
+#define AHBSRAM0 __attribute__((section("AHBSRAM0"), aligned(4)))
+#define AHBSRAM1 __attribute__((section("AHBSRAM1"), aligned(4)))
+#else
+#define AHBSRAM0
+#define AHBSRAM1
+#endif
+
 
 /////////////////////////////////////////
 // Global Variables
@@ -10,45 +10,254 @@
 
 #include "graphics.h"
 #include "globals.h"
+#include "map.h"
+#include "sprites.h"
+#include "font.h"
 
 
+static int tint = TINT_NONE; // Palette filter applied to every sprite
 
-///////////////////////////////////////////
-// Drawing Images based on Characters
-///////////////////////////////////////////
+void set_tint(int t)
+{
+    tint = t;
+}
 
-//Additional color definitions
-#define YELLOW 0xFFFF00
-#define BROWN  0xD2691E
-#define DIRT   BROWN
-#define PINK   0x746AB0
-#define RED    0xE83845
-#define AQUA   0x288BA8
-// You can define more hex colors here
+int get_tint()
+{
+    return tint;
+}
 
+/**
+ * Applies the current tint to one RGB565 colour.
+ */
+static uint16_t tint_color(uint16_t c)
+{
+    switch (tint)
+    {
+        case TINT_FLASH: return c ? 0xF800 : 0;                 // solid red
+        case TINT_NIGHT: return ((c >> 1) & 0x7BE0) | (c & 0x1F); // halve red and green
+        default: return c;
+    }
+}
 
-//Function to draw images based on characters
-// - The function takes an image array and changes the color 
-//   labeled by a character to a hex value (ex: 'Y' -> 0xFFF00)
-void draw_img(int u, int v, const char* img)
+/**
+ * Expands the 4-bit pixels of a sprite into RGB565 through pal, unrolled to
+ * eight pixels per pass.
+ */
+static void expand_sprite(const Sprite* s, const uint16_t* pal, uint16_t* out)
 {
-    int colors[11*11];
-    for (int i = 0; i < 11*11; i++)
+    const uint8_t* p = s->pixels;
+    for (int n = SPRITE_PIXELS / 8; n > 0; n--)
     {
-        //You can add more characters by defining their hex values above
-        if (img[i] == 'R') colors[i] = RED;
-        else if (img[i] == 'Y') colors[i] = YELLOW;
-        else if (img[i] == 'G') colors[i] = GREEN;
-        else if (img[i] == 'P') colors[i] = PINK;
-        else if (img[i] == 'R') colors[i] = RED;
-        else if (img[i] == 'A') colors[i] = AQUA;
-        else if (img[i] == 'D') colors[i] = DIRT;
-        else if (img[i] == '5') colors[i] = LGREY;
-        else if (img[i] == '3') colors[i] = DGREY;
-        else colors[i] = BLACK;
+        uint8_t b0 = p[0], b1 = p[1], b2 = p[2], b3 = p[3];
+        out[0] = pal[b0 >> 4]; out[1] = pal[b0 & 0xF];
+        out[2] = pal[b1 >> 4]; out[3] = pal[b1 & 0xF];
+        out[4] = pal[b2 >> 4]; out[5] = pal[b2 & 0xF];
+        out[6] = pal[b3 >> 4]; out[7] = pal[b3 & 0xF];
+        p += 4;
+        out += 8;
     }
-    uLCD.BLIT(u, v, 11, 11, colors);
-    wait_us(250); // Recovery time!
+    for (int i = 0; i < SPRITE_PIXELS % 8; i++) // the odd pixel left over
+    {
+        out[i] = pal[(i & 1) ? (p[i/2] & 0xF) : (p[i/2] >> 4)];
+    }
+}
+
+// Converts 0xRRGGBB to RGB565 the way BLIT does
+#define RGB565(c) ((((c) >> 8) & 0xF800) | (((c) >> 5) & 0x07E0) | (((c) >> 3) & 0x001F))
+
+// The strip being composed between gfx_begin and gfx_flush
+static uint16_t strip[GFX_STRIP_PIXELS] AHBSRAM0;
+static int strip_on;                 // Nonzero while drawing goes to strip
+static int strip_x, strip_y;         // Screen position of its top left pixel
+static int strip_w, strip_h;         // Its size in pixels
+
+void gfx_begin(int x, int y, int w, int h)
+{
+    strip_on = w * h <= GFX_STRIP_PIXELS; // too big: draw straight to the LCD
+    strip_x = x;
+    strip_y = y;
+    strip_w = w;
+    strip_h = h;
+}
+
+void gfx_flush()
+{
+    if (strip_on) uLCD.BLIT565(strip_x, strip_y, strip_w, strip_h, strip);
+    strip_on = false;
+}
+
+void gfx_fill(int x1, int y1, int x2, int y2, int color)
+{
+    if (!strip_on)
+    {
+        uLCD.filled_rectangle(x1, y1, x2, y2, color);
+        return;
+    }
+    // Clip to the strip
+    if (x1 < strip_x) x1 = strip_x;
+    if (y1 < strip_y) y1 = strip_y;
+    if (x2 >= strip_x + strip_w) x2 = strip_x + strip_w - 1;
+    if (y2 >= strip_y + strip_h) y2 = strip_y + strip_h - 1;
+    uint16_t c = RGB565(color);
+    for (int y = y1; y <= y2; y++)
+    {
+        uint16_t* row = strip + (y - strip_y) * strip_w;
+        for (int x = x1; x <= x2; x++) row[x - strip_x] = c;
+    }
+}
+
+static int scroll_refused = false; // The LCD refused a screen copy once
+
+int gfx_can_scroll()
+{
+    return !scroll_refused;
+}
+
+int gfx_scroll(int x, int y, int w, int h, int dx, int dy)
+{
+    // The copy is done in bands no wider than the shift, starting from the
+    // side things move towards, so no band overlaps its own destination
+    // or a band not yet copied, whichever way the LCD copies. The first band
+    // without an ACK ends it: the firmware will not do better next time.
+    if (scroll_refused) return false;
+    if (dx)
+    {
+        int step = abs(dx);
+        for (int n = 0; n < w - step && !scroll_refused; n += step)
+        {
+            int bw = w - step - n < step ? w - step - n : step;
+            int xd = dx < 0 ? x + n : x + w - n - bw; // destination band
+            scroll_refused = uLCD.screen_copy(xd - dx, y, xd, y, bw, h) != 1;
+        }
+    }
+    else if (dy)
+    {
+        int step = abs(dy);
+        for (int n = 0; n < h - step && !scroll_refused; n += step)
+        {
+            int bh = h - step - n < step ? h - step - n : step;
+            int yd = dy < 0 ? y + n : y + h - n - bh;
+            scroll_refused = uLCD.screen_copy(x, yd - dy, x, yd, w, bh) != 1;
+        }
+    }
+    return !scroll_refused;
+}
+
+/**
+ * Draws an 11x11 sprite from sprites.cpp, in the strip or on the LCD.
+ * Tinting only touches the few palette entries, never the pixels. In the
+ * strip, see-through pixels (the sprite's key) keep what was drawn there
+ * before, so a sprite drawn over a tile blends with it; on the LCD they are
+ * black.
+ */
+static void draw_sprite(int u, int v, const Sprite* s)
+{
+    uint16_t pal[SPRITE_COLORS];
+    const uint16_t* palette = s->palette;
+    if (tint != TINT_NONE)
+    {
+        for (int i = 0; i < s->colors; i++) pal[i] = tint_color(s->palette[i]);
+        palette = pal;
+    }
+    uint16_t px[SPRITE_PIXELS];
+    expand_sprite(s, palette, px);
+    if (!strip_on)
+    {
+        uLCD.BLIT565(u, v, SPRITE_SIZE, SPRITE_SIZE, px); // waits for the LCD's ACK
+        return;
+    }
+    for (int j = 0; j < SPRITE_SIZE; j++) // copy the rows that fall in the strip
+    {
+        int y = v + j - strip_y;
+        if (y < 0 || y >= strip_h) continue;
+        for (int i = 0; i < SPRITE_SIZE; i++)
+        {
+            int x = u + i - strip_x;
+            if (x < 0 || x >= strip_w) continue;
+            int n = j * SPRITE_SIZE + i;
+            if (s->key != SPRITE_OPAQUE &&
+                ((n & 1) ? (s->pixels[n/2] & 0xF) : (s->pixels[n/2] >> 4)) == s->key)
+                continue; // see-through
+            strip[y * strip_w + x] = px[n];
+        }
+    }
+}
+
+int draw_text(int x, int y, const char* s, int color, int bg, int scale)
+{
+    uint16_t fg = RGB565(color);
+    uint16_t back = RGB565(bg);
+    int cw = GLYPH_ADVANCE * scale; // Size of one character
+    int ch = GLYPH_LINE * scale;
+    int per = GFX_STRIP_PIXELS / (cw * ch); // Characters per blit
+    if (per == 0) return 0; // scale too big for the strip
+
+    int len = strlen(s);
+    for (int first = 0; first < len; first += per)
+    {
+        int count = len - first < per ? len - first : per;
+        gfx_begin(x + first * cw, y, count * cw, ch);
+        for (int k = 0; k < count; k++)
+        {
+            unsigned char c = s[first + k];
+            if (c < GLYPH_FIRST || c > GLYPH_LAST) c = ' ';
+            const uint8_t* glyph = GLYPHS[c - GLYPH_FIRST];
+            for (int col = 0; col < GLYPH_ADVANCE; col++)
+            {
+                uint8_t bits = col < GLYPH_W ? glyph[col] : 0; // gap after it
+                uint16_t* out = strip + k * cw + col * scale;
+                for (int row = 0; row < ch; row++)
+                {
+                    uint16_t p = (bits >> (row / scale)) & 1 ? fg : back;
+                    for (int i = 0; i < scale; i++) out[i] = p;
+                    out += strip_w;
+                }
+            }
+        }
+        gfx_flush();
+    }
+    return len * cw;
+}
+
+// Tiles each method draws in blit_benchmark
+#define BENCH_TILES 32
+
+void blit_benchmark()
+{
+    int colors[SPRITE_PIXELS];
+    uint16_t px[SPRITE_PIXELS];
+    expand_sprite(&SPRITE_NPC, SPRITE_NPC.palette, px);
+    Timer t;
+
+    t.start(); // the old path: widen to 0xRRGGBB, BLIT, recovery wait
+    for (int n = 0; n < BENCH_TILES; n++)
+    {
+        for (int i = 0; i < SPRITE_PIXELS; i++)
+            colors[i] = ((px[i] >> 11) << 19) | (((px[i] >> 5) & 0x3F) << 10) | ((px[i] & 0x1F) << 3);
+        uLCD.BLIT(3, 15, SPRITE_SIZE, SPRITE_SIZE, colors);
+        wait_us(250);
+    }
+    int old_us = t.read_us();
+
+    t.reset(); // the new path: expand and stream RGB565
+    for (int n = 0; n < BENCH_TILES; n++)
+    {
+        draw_sprite(3, 15, &SPRITE_NPC);
+    }
+    int new_us = t.read_us();
+
+    pc.printf("tile draw: BLIT %d us, BLIT565 %d us (%d tiles each)\r\n",
+              old_us / BENCH_TILES, new_us / BENCH_TILES, BENCH_TILES);
+
+    char line[] = "The quick brown fox";
+    t.reset();
+    uLCD.text_string(line, 0, 2, FONT_5X7, WHITE);
+    old_us = t.read_us();
+    t.reset();
+    draw_text(0, 16, line, WHITE, BLACK, 1);
+    new_us = t.read_us();
+    pc.printf("text line: text_string %d us, draw_text %d us\r\n", old_us, new_us);
 }
 
 
@@ -58,57 +267,31 @@ void draw_img(int u, int v, const char* img)
 
 void draw_nothing(int u, int v)
 {
-    uLCD.filled_rectangle(u, v, u+10, v+10, BLACK);
+    gfx_fill(u, v, u+10, v+10, BLACK);
 }
 
 void draw_player(int u, int v, int key)
 {
-    if (key)
-    {
-       // uLCD.filled_rectangle(u, v, u+11, v+11, YELLOW);
-        const char* img = 
-            "           "
-            " PP        "
-            "PPPPP      "
-            "PP  PY     "
-            "   PPPYY   "
-            "     PPYYY "
-            "   PP  YY  "
-            "  PPPPPY   "
-            " PP  PP    "
-            "PPPPPPPPP  "
-            "           ";
-        draw_img(u, v, img);
-    }
-    else
-    {
-        //uLCD.filled_rectangle(u, v, u+11, v+11, PINK);
-        const char* img = 
-            "           "
-            " PP        "
-            "PPPPP      "
-            "PP  PP     "
-            "   PPPPP   "
-            "     PPPPP "
-            "   PP  PP  "
-            "  PPPPPP   "
-            " PP  PP    "
-            "PPPPPPPPP  "
-            "           ";
-        draw_img(u, v, img);
-    }
+    draw_sprite(u, v, key ? &SPRITE_PLAYER_KEY : &SPRITE_PLAYER);
 }
 
 
 void draw_wall(int u, int v)
 {
-    uLCD.filled_rectangle(u, v, u+10, v+10, DGREY);
+    gfx_fill(u, v, u+10, v+10, DGREY);
+}
+
+int tile_fill(DrawFunc draw)
+{
+    if (draw == draw_nothing) return BLACK;
+    if (draw == draw_wall) return DGREY;
+    return -1;
 }
 
 void draw_door(int u, int v)
 {
     draw_nothing(u,v);
-    uLCD.line(u, v+6, u+11, v+6, 0xFFFF00);
+    gfx_fill(u, v+6, u+11, v+6, 0xFFFF00);
 }
 
 /**
@@ -139,171 +322,126 @@ void draw_border()
 }
 
 ///////////////////////////////////////////
-//Sprite drawing of objects using draw_img function
+//Sprite drawing of objects. The art is in assets/sprites.txt.
 ///////////////////////////////////////////
 
 void draw_plant(int u, int v)
 {
-    const char* img = 
-        "           "
-        " GGGGGGGG  "
-        " GGGGGGGGG "
-        "GGGGGGGGGGG"
-        "GGGGGGGGGGG"
-        " GGGGGGGG  "
-        "    DD     "
-        "    DD     "
-        "    DD     "
-        "   DDDDD   "
-        "  D  D  D  ";
-    draw_img(u, v, img);
+    draw_sprite(u, v, &SPRITE_PLANT);
 }
 
 void draw_other_plant(int u, int v)
 {
-    const char* img = 
-        "           "
-        "   AAA     "
-        "  AAAAAA   "
-        " AAAAAAAA  "
-        "AAAAAAAAAAA"
-        " AAAAAAAA  "
-        "    DDD    "
-        "    DDD    "
-        "    DDD    "
-        "   RRRRR   "
-        "  B  B  B  ";
-    draw_img(u, v, img);
+    draw_sprite(u, v, &SPRITE_OTHER_PLANT);
 }
 
 void draw_npc(int u, int v)
 {
-    const char* img = 
-        "     R     "
-        "    RRR    "
-        "   RRRRR   "
-        "  RRRRRRR  "
-        " RRRRYRRRR "
-        "RRRRYYYRRRR"
-        " RRRRYRRRR "
-        "  RRRRRRR  "
-        "   RRRRR   "
-        "    RRR    "
-        "     R     ";
-    draw_img(u, v, img);
+    draw_sprite(u, v, &SPRITE_NPC);
 }
 
 void draw_stairs(int u, int v)
 {
-    const char* img =
-        "        333"
-        "        353"
-        "      33333"
-        "      35553"
-        "    3333333"
-        "    3555553"
-        "  333333333"
-        "  355555553"
-        "33333333333"
-        "35555555553"
-        "33333333333";
-    draw_img(u, v, img);
+    draw_sprite(u, v, &SPRITE_STAIRS);
 }
 
 
 
 ////////////////////////////////////////////
-//Examples of Piskel sprite C array export
+//Sprites exported from Piskel
 ////////////////////////////////////////////
 
 void draw_buzz(int u, int v)
 {
-
-int new_piskel_data[121] = {
-0x00000000, 0x00000000, 0x00000000, 0xff58110c, 0xff58110c, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 
-0x00000000, 0x00000000, 0xff58110c, 0x00000000, 0x00000000, 0xff58110c, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 
-0x00000000, 0x00000000, 0x00000000, 0xffffff00, 0xffffffff, 0xff0000ff, 0xff606060, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 
-0x00000000, 0x00000000, 0xffffff00, 0xffffff00, 0xff0000ff, 0xffffffff, 0xff0000ff, 0xffffffff, 0xffffffff, 0x00000000, 0x00000000, 
-0x00000000, 0xffffff00, 0xffffff00, 0xffffff00, 0xff0000ff, 0xff0000ff, 0xff606060, 0xffffffff, 0xffffffff, 0xffffffff, 0x00000000, 
-0x00000000, 0x00000000, 0xffffff00, 0xffffffff, 0xffffffff, 0xffffff00, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0x00000000, 
-0x00000000, 0x00000000, 0x00000000, 0xffffff00, 0xffffff00, 0xff58110c, 0xff58110c, 0xff137bff, 0xffffffff, 0x00000000, 0x00000000, 
-0xff137bff, 0x00000000, 0xff137bff, 0xff58110c, 0xff58110c, 0xff58110c, 0xffffff00, 0xff58110c, 0xff137bff, 0x00000000, 0x00000000, 
-0x00000000, 0xff137bff, 0xff137bff, 0x00000000, 0x00000000, 0xffffff00, 0xff137bff, 0xff137bff, 0x00000000, 0x00000000, 0x00000000, 
-0x00000000, 0x00000000, 0x00000000, 0xffffff00, 0xffffff00, 0xff58110c, 0xff58110c, 0xff58110c, 0x00000000, 0x00000000, 0x00000000, 
-0x00000000, 0x00000000, 0x00000000, 0x00000000, 0xff58110c, 0xffffff00, 0xffffff00, 0x00000000, 0x00000000, 0x00000000, 0x00000000
-};
-
-   uLCD.BLIT(u,v, 11,11, new_piskel_data);
-        
+    draw_sprite(u, v, &SPRITE_BUZZ);
 }
 
 
 
-void draw_water(int u, int v)
-{
+// Animated tiles. Each animation is a set of frames from sprites.cpp shown
+// in turn, each for a number of game frames.
+
+/**
+ * One animation: its frames and how long each one is shown.
+ */
+struct Animation {
+    DrawFunc draw;          // The DrawFunc that shows it
+    const Sprite* frames;   // Frame images
+    int nframes;            // Number of frames
+    int period;             // Game frames each image stays up
+};
 
+// Number of frames in a sprite frame array
+#define FRAMES(s) (int)(sizeof(s) / sizeof(s[0]))
 
-int new_piskel_data[121] = {
+static const Animation ANIMATIONS[] = {
+    {draw_water, SPRITE_WATER, FRAMES(SPRITE_WATER), 6},
+    {draw_fire,  SPRITE_FIRE,  FRAMES(SPRITE_FIRE),  2},
+    {draw_earth, SPRITE_EARTH, FRAMES(SPRITE_EARTH), 4},
+};
+#define NUM_ANIMATIONS (int)(sizeof(ANIMATIONS) / sizeof(ANIMATIONS[0]))
+#define ANIM_WATER 0
+#define ANIM_FIRE  1
+#define ANIM_EARTH 2
 
-0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0xff0101c4, 0xff0101c4, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 
-0x00000000, 0x00000000, 0x00000000, 0x00000000, 0xff0101c4, 0xff0101c4, 0xff0101c4, 0xff0101c4, 0x00000000, 0x00000000, 0x00000000, 
-0x00000000, 0x00000000, 0x00000000, 0xff0101c4, 0xff0101c4, 0xff0101c4, 0xff0101c4, 0xff0101c4, 0xff0101c4, 0x00000000, 0x00000000, 
-0x00000000, 0x00000000, 0xff0101c4, 0xff0101c4, 0xff7c7cff, 0xff7c7cff, 0xff7c7cff, 0xff0101c4, 0xff0101c4, 0xff0101c4, 0x00000000, 
-0x00000000, 0xff0101c4, 0xff0101c4, 0xff0101c4, 0xff7c7cff, 0xff7c7cff, 0xff7c7cff, 0xff7c7cff, 0xff0101c4, 0xff0101c4, 0x00000000, 
-0x00000000, 0xff0101c4, 0xff0101c4, 0xff7c7cff, 0xff7c7cff, 0xff7c7cff, 0xff7c7cff, 0xff7c7cff, 0xff0101c4, 0xff0101c4, 0x00000000, 
-0x00000000, 0xff0101c4, 0xff0101c4, 0xff7c7cff, 0xff7c7cff, 0xff7c7cff, 0xff7c7cff, 0xff7c7cff, 0xff0101c4, 0xff0101c4, 0x00000000, 
-0x00000000, 0xff0101c4, 0xff0101c4, 0xff7c7cff, 0xff7c7cff, 0xff7c7cff, 0xff7c7cff, 0xff7c7cff, 0xff0101c4, 0xff0101c4, 0x00000000, 
-0x00000000, 0x00000000, 0xff0101c4, 0xff7c7cff, 0xff7c7cff, 0xff7c7cff, 0xff7c7cff, 0xff7c7cff, 0xff0101c4, 0xff0101c4, 0x00000000, 
-0x00000000, 0x00000000, 0xff0101c4, 0xff0101c4, 0xff7c7cff, 0xff7c7cff, 0xff7c7cff, 0xff7c7cff, 0xff0101c4, 0xff0101c4, 0x00000000, 
-0x00000000, 0x00000000, 0x00000000, 0xff0101c4, 0xff0101c4, 0xff0101c4, 0xff0101c4, 0xff0101c4, 0x00000000, 0x00000000, 0x00000000
+static unsigned anim_clock;  // Game frames since boot, see anim_tick
+static int anim_changed;     // Bit per animation whose frame just changed
 
-};    
-   uLCD.BLIT(u,v, 11,11, new_piskel_data);
-        
+/**
+ * Returns the frame animation a is showing now.
+ */
+static int anim_frame(int a)
+{
+    return (anim_clock / ANIMATIONS[a].period) % ANIMATIONS[a].nframes;
 }
 
-void draw_fire(int u, int v)
+/**
+ * Draws the current frame of animation a.
+ */
+static void draw_anim(int u, int v, int a)
 {
+    draw_sprite(u, v, &ANIMATIONS[a].frames[anim_frame(a)]);
+}
 
-int new_piskel_data[121] = {
-
-0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 
-0xffff0009, 0xffff0009, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 
-0xffff0009, 0xffff0009, 0xffff0009, 0xffff0009, 0x00000000, 0xffff0009, 0xffff0009, 0xffff0009, 0x00000000, 0x00000000, 0x00000000, 
-0xffff0009, 0xffff0009, 0xffdeb200, 0xffff0009, 0x00000000, 0xffff0009, 0xffdeb200, 0xffff0009, 0xffff0009, 0x00000000, 0x00000000, 
-0x00000000, 0xffff0009, 0xffdeb200, 0xffdeb200, 0xffff0009, 0xffdeb200, 0xffdeb200, 0xffff0009, 0xffff0009, 0x00000000, 0x00000000, 
-0x00000000, 0xffff0009, 0xffdeb200, 0xffdeb200, 0xffdeb200, 0xffdeb200, 0xffdeb200, 0xffff0009, 0xffff0009, 0xffff0009, 0x00000000, 
-0x00000000, 0xffff0009, 0xffde4600, 0xffde4600, 0xffdeb200, 0xffdeb200, 0xffdeb200, 0xffff0009, 0xffff0009, 0xffff0009, 0xffff0009, 
-0xffff0009, 0xffff0009, 0xffde4600, 0xffde4600, 0xffde4600, 0xffde4600, 0xffde4600, 0xffff0009, 0xffde4600, 0xffde4600, 0xffff0009, 
-0xffff0009, 0xffb30007, 0xffb30007, 0xffb30007, 0xffde4600, 0xffde4600, 0xffde4600, 0xffde4600, 0xffde4600, 0xffff0009, 0xffff0009, 
-0xffff0009, 0xffb30007, 0xffb30007, 0xffb30007, 0xffde4600, 0xffde4600, 0xffb30007, 0xffb30007, 0xffb30007, 0xffff0009, 0x00000000, 
-0xffff0009, 0xffff0009, 0xffff0009, 0xffb30007, 0xffb30007, 0xffb30007, 0xffb30007, 0xffb30007, 0xffff0009, 0xffff0009, 0xffff0009
+int anim_tick()
+{
+    anim_changed = 0;
+    anim_clock++;
+    for (int a = 0; a < NUM_ANIMATIONS; a++) {
+        if (anim_clock % ANIMATIONS[a].period == 0) anim_changed |= 1 << a;
+    }
+    return anim_changed;
+}
 
-};    
-   uLCD.BLIT(u,v, 11,11, new_piskel_data);
-        
+int anim_image(DrawFunc draw)
+{
+    for (int a = 0; a < NUM_ANIMATIONS; a++) {
+        if (ANIMATIONS[a].draw == draw) return anim_frame(a);
+    }
+    return 0; // not animated
 }
 
-void draw_earth(int u, int v)
+int anim_bit(DrawFunc draw)
 {
+    for (int a = 0; a < NUM_ANIMATIONS; a++) {
+        if (ANIMATIONS[a].draw == draw) return 1 << a;
+    }
+    return 0; // not animated
+}
 
-int new_piskel_data[121] = {
+void draw_water(int u, int v)
+{
+    draw_anim(u, v, ANIM_WATER);
+}
 
-0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 
-0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 
-0x00000000, 0x00000000, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0x00000000, 0x00000000, 0x00000000, 0x00000000, 
-0x00000000, 0x00000000, 0xffffffff, 0xff00659e, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff, 0x00000000, 0x00000000, 
-0x00000000, 0xffffffff, 0xffffffff, 0xff00659e, 0xff00659e, 0xff00659e, 0xff00659e, 0xff00659e, 0xffffffff, 0xffffffff, 0x00000000, 
-0x00000000, 0xffffffff, 0xffffffff, 0xffffffff, 0xff00659e, 0xff00659e, 0xff00659e, 0xff00659e, 0xff00659e, 0xffffffff, 0x00000000, 
-0xffffffff, 0xffffffff, 0xff00659e, 0xffffffff, 0xffffffff, 0xff00659e, 0xff00659e, 0xff00659e, 0xff00659e, 0xffffffff, 0x00000000, 
-0xffffffff, 0xff00659e, 0xff00659e, 0xff00659e, 0xffffffff, 0xff00659e, 0xff00659e, 0xff00659e, 0xff00659e, 0xffffffff, 0x00000000, 
-0xffffffff, 0xff00659e, 0xff00659e, 0xff00659e, 0xffffffff, 0xff00659e, 0xff00659e, 0xff00659e, 0xffffffff, 0xffffffff, 0xffffffff, 
-0xffffffff, 0xff00659e, 0xff00659e, 0xff00659e, 0xffffffff, 0xff00659e, 0xff00659e, 0xffffffff, 0xff00659e, 0xff00659e, 0xff00659e, 
-0xff00659e, 0xff00659e, 0xff00659e, 0xff00659e, 0xffffffff, 0xff00659e, 0xffffffff, 0xffffffff, 0xff00659e, 0xff00659e, 0xff00659e
+void draw_fire(int u, int v)
+{
+    draw_anim(u, v, ANIM_FIRE);
+}
 
-};    
-   uLCD.BLIT(u,v, 11,11, new_piskel_data);
-        
+void draw_earth(int u, int v)
+{
+    draw_anim(u, v, ANIM_EARTH);
 }
 
 
@@ -316,83 +454,23 @@ int new_piskel_data[121] = {
 
 void draw_cave1(int u, int v)
 {
-    const char* img =
-        "33333333333"
-        "33333333333"
-        "33333333333"
-        "33333333333"
-        "33333333333"
-        "33333333333"
-        "33333333333"
-        "33333333333"
-        "33333333333"
-        "33333333333"
-        "33333333333";
-    draw_img(u, v, img);
+    draw_sprite(u, v, &SPRITE_CAVE1);
 }
 void draw_cave2(int u, int v)
 {
-    const char* img =
-        "33333333333"
-        "33333333333"
-        "33333333333"
-        "33333333333"
-        "33333333333"
-        "33333333333"
-        "33333333333"
-        "33333333333"
-        "33333333333"
-        "33333333333"
-        "33333333333";
-    draw_img(u, v, img);
+    draw_sprite(u, v, &SPRITE_CAVE2);
 }
 void draw_cave3(int u, int v)
 {
-    const char* img =
-        "33333333333"
-        "33333333333"
-        "33333333333"
-        "33333333333"
-        "33333333333"
-        "33333333333"
-        "33333333333"
-        "33333333333"
-        "33333333000"
-        "33333333000"
-        "33333333000";
-    draw_img(u, v, img);
+    draw_sprite(u, v, &SPRITE_CAVE3);
 }
 void draw_cave4(int u, int v)
 {
-    const char* img =
-        "33333333333"
-        "33333333333"
-        "33333333333"
-        "33333333333"
-        "33333333333"
-        "33333333333"
-        "33333333333"
-        "33333333333"
-        "33333333333"
-        "33333333333"
-        "33333333333";
-    draw_img(u, v, img);
+    draw_sprite(u, v, &SPRITE_CAVE4);
 }
 
 
 void draw_mud(int u, int v)
 {
-   const char* img = 
-        "DDDDDDDDDDD"
-        "DDD3333DD3D"
-        "D33D33D33DD"
-        "D3DDD33D33D"
-        "DD333D333DD"
-        "D33D33DDDD"
-        "DDD333D333D"
-        "DD3DDD3DD3D"
-        "D3D333D33DD"
-        "DDDDD33DDDD"
-        "DDDDDDDDDDD";
-    draw_img(u, v, img);
+    draw_sprite(u, v, &SPRITE_MUD);
 }
@@ -11,20 +11,67 @@
 #ifndef GRAPHICS_H
 #define GRAPHICS_H
 
+// Pixels in the compositing strip: one row of tiles across the map view
+#define GFX_STRIP_PIXELS (11*11*11)
+
+/**
+ * Starts composing the screen rectangle at (x,y), w by h pixels, in RAM.
+ * Until gfx_flush, the DrawFuncs and draw_player paint into that buffer
+ * instead of sending commands to the LCD. Anything they draw outside the
+ * rectangle is clipped. A rectangle over GFX_STRIP_PIXELS is drawn directly.
+ */
+void gfx_begin(int x, int y, int w, int h);
+
+/**
+ * Sends the rectangle started by gfx_begin to the LCD with one blit.
+ */
+void gfx_flush();
+
+/**
+ * Fills the rectangle from (x1,y1) to (x2,y2), inclusive, with a 0xRRGGBB
+ * colour: in the strip between gfx_begin and gfx_flush, else on the LCD
+ * with one command.
+ */
+void gfx_fill(int x1, int y1, int x2, int y2, int color);
+
+/**
+ * Returns the one colour a DrawFunc fills its whole tile with (draw_nothing,
+ * draw_wall), or -1 if it draws anything more.
+ */
+int tile_fill(void (*draw)(int u, int v));
+
+/**
+ * Moves what is on the screen in the rectangle at (x,y), w by h pixels, by
+ * dx pixels across or dy pixels down (only one may be nonzero), using the
+ * LCD's own screen copy. The strip uncovered on the far side is left as it
+ * was. Returns false if the LCD refused or did not answer a copy; the
+ * rectangle must then be redrawn, and gfx_scroll does nothing from then on.
+ */
+int gfx_scroll(int x, int y, int w, int h, int dx, int dy);
+
+/**
+ * Returns false once the LCD has refused a screen copy, so callers can skip
+ * scrolling and redraw instead.
+ */
+int gfx_can_scroll();
+
 /**
- * Takes a string image and draws it to the screen. The string is 121 characters
- * long, and represents an 11x11 tile in row-major ordering (across, then down,
- * like a regular multi-dimensional array). The available colors are:
- *      R = Red
- *      Y = Yellow
- *      G = Green
- *      D = Brown ("dirt")
- *      5 = Light grey (50%)
- *      3 = Dark grey (30%)
- *      Any other character is black
- * More colors can be easily added by following the pattern already given.
+ * Draws text in the 5x7 font of font.h with its top left corner at (x,y),
+ * in color on bg (0xRRGGBB). Each font pixel is scale x scale pixels; scale
+ * may be 1 to 5. The text is composed in the strip and sent as blits, one
+ * per 27 characters at scale 1, instead of through the LCD's text commands.
+ * Characters the font lacks draw as spaces. Returns the width drawn in
+ * pixels.
  */
-void draw_img(int u, int v, const char* img);
+int draw_text(int x, int y, const char* s, int color, int bg, int scale);
+
+/**
+ * Times drawing a sprite tile through BLIT (0xRRGGBB ints) and through
+ * BLIT565 (packed pixels), and a line of text through text_string and
+ * draw_text, and prints the times over pc. Draws over the top of the map
+ * view.
+ */
+void blit_benchmark();
 
 /**
  * Draws the player. This depends on the player state, so it is not a DrawFunc.
@@ -47,6 +94,42 @@ void draw_lower_status();
 void draw_border();
 
 
+// Palette filters for set_tint
+#define TINT_NONE  0    // Sprites as drawn
+#define TINT_FLASH 1    // Everything but black turns red, e.g. a hit
+#define TINT_NIGHT 2    // Darker and bluer
+
+/**
+ * Sets the palette filter applied to every sprite drawn from now on. It only
+ * recolours the sprite's palette, so it costs nothing per pixel.
+ */
+void set_tint(int tint);
+
+/**
+ * Returns the tint set by set_tint.
+ */
+int get_tint();
+
+/**
+ * Advances the animation clock by one game frame. Call once per frame before
+ * drawing. Returns a bit per animation whose image changes on this frame,
+ * zero when no animated tile needs redrawing.
+ */
+int anim_tick();
+
+/**
+ * Returns the frame an animated DrawFunc (water, fire, earth) is showing
+ * now, or 0 for any other DrawFunc. Tiles drawn by the same DrawFunc with
+ * the same frame look the same.
+ */
+int anim_image(void (*draw)(int u, int v));
+
+/**
+ * Returns the bit anim_tick uses for the animation an animated DrawFunc
+ * shows, or 0 for any other DrawFunc.
+ */
+int anim_bit(void (*draw)(int u, int v));
+
 /**
  * DrawFunc functions. 
  * These can be used as the MapItem draw functions.
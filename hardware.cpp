@@ -28,6 +28,7 @@ PwmOut speaker(p26);
 wave_player waver(&DACout);
 Nav_Switch navs(p12,p15,p14,p16,p13);       // Nav Switch
 BusOut mbedleds(LED1,LED2,LED3,LED4);
+LocalFileSystem local("local");             // mbed flash drive, holds the save
 //SDFileSystem sd(p5, p6, p7, p8, "sd");    // SD Card(mosi, miso, sck, cs)
 
 
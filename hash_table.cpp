@@ -306,3 +306,45 @@ void deleteItem(HashTable *hashTable, unsigned int key)
         free(testEntry); // frees if key is present
     }
 }
+/**
+ * forEachItem
+ *
+ * Walks every bucket's linked list and hands each entry to the visitor.
+ *
+ * @param hashTable The pointer to the hash table
+ * @param visit The function called with each key and value
+ * @param arg Passed through to the visitor
+ */
+void forEachItem(HashTable *hashTable, HashVisitor visit, void *arg)
+{
+    if (hashTable == NULL) {
+        return; // hashtable does not exist
+    }
+    for (unsigned int i = 0; i < hashTable->num_buckets; i++) { // loop through buckets
+        for (HashTableEntry *tempEntry = hashTable->buckets[i]; tempEntry != NULL; tempEntry = tempEntry->next) {
+            visit(tempEntry->key, tempEntry->value, arg);
+        }
+    }
+}
+/**
+ * clearHashTable
+ *
+ * Frees every entry but not the values, and empties all buckets.
+ *
+ * @param hashTable The pointer to the hash table
+ */
+void clearHashTable(HashTable *hashTable)
+{
+    if (hashTable == NULL) {
+        return; // hashtable does not exist
+    }
+    for (unsigned int i = 0; i < hashTable->num_buckets; i++) { // loop through buckets
+        HashTableEntry *tempEntry = hashTable->buckets[i]; // set temp to head
+        while (tempEntry != NULL) {
+            HashTableEntry *nextEntry = tempEntry->next;
+            free(tempEntry); // frees the node only
+            tempEntry = nextEntry;
+        }
+        hashTable->buckets[i] = NULL;
+    }
+}
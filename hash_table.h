@@ -57,6 +57,13 @@ typedef struct _HashTable HashTable;
  */
 typedef struct _HashTableEntry HashTableEntry;
 
+/**
+ * This defines a type that is a pointer to a function which is called for
+ * one entry of a hash table by forEachItem. It gets the entry's key and value
+ * and the arg pointer that was passed to forEachItem.
+ */
+typedef void (*HashVisitor)(unsigned int key, void* value, void* arg);
+
 /**
  * createHashTable
  *
@@ -134,4 +141,28 @@ void* removeItem(HashTable* myHashTable, unsigned int key);
  */
 void deleteItem(HashTable* myHashTable, unsigned int key);
 
+/**
+ * forEachItem
+ *
+ * Call visit once for every entry in the hash table, bucket by bucket. The
+ * hash table must not be modified until forEachItem returns.
+ *
+ * @param myHashTable The pointer to the hash table.
+ * @param visit The function to call with each key and value.
+ * @param arg Passed through to every call of visit.
+ */
+void forEachItem(HashTable* myHashTable, HashVisitor visit, void* arg);
+
+/**
+ * clearHashTable
+ *
+ * Free every hash table entry, leaving an empty hash table that can still be
+ * used. Unlike destroyHashTable, the values are NOT freed, so values that
+ * are shared or not on the heap can be stored. Use forEachItem first to free
+ * values that need it.
+ *
+ * @param myHashTable The pointer to the hash table.
+ */
+void clearHashTable(HashTable* myHashTable);
+
 #endif
\ No newline at end of file
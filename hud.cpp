@@ -0,0 +1,67 @@
+//=================================================================
+// The HUD class file.
+//
+// Copyright 2023 Georgia Tech. All rights reserved.
+// The materials provided by the instructor in this course are for
+// the use of the students currently enrolled in the course.
+// Copyrighted course materials may not be further disseminated.
+// This file must NOT be made publicly available anywhere.
+//==================================================================
+
+#include "hud.h"
+#include "globals.h"
+#include "graphics.h"
+
+// Text rows of the upper and lower status bars
+#define HUD_TOP    1
+#define HUD_BOTTOM 120
+
+/**
+ * Where and how a field is drawn.
+ */
+struct HudField {
+    short x, y;         // Top left corner of its rectangle
+    char width;         // Characters it takes; the text is padded to this
+    const char* label;  // Shown before the value, or alone for a flag
+    char flag;          // Nonzero to show only the label, while nonzero
+    int color;          // Text colour
+};
+
+static const HudField fields[NUM_HUD_FIELDS] = {
+    {  1, HUD_TOP,    5, "X:",      false, WHITE},  // HUD_X
+    { 37, HUD_TOP,    5, "Y:",      false, WHITE},  // HUD_Y
+    { 97, HUD_TOP,    5, "MAP ",    false, WHITE},  // HUD_MAP
+    {  1, HUD_BOTTOM, 3, "KEY",     true,  0xFFFF00}, // HUD_KEY
+    { 85, HUD_BOTTOM, 7, "RAMBLIN", true,  RED},    // HUD_RAMBLIN
+};
+
+static int shown[NUM_HUD_FIELDS];   // Value each field shows
+static bool valid[NUM_HUD_FIELDS];  // False if the screen may not show it
+
+void hud_invalidate()
+{
+    for (int f = 0; f < NUM_HUD_FIELDS; f++) valid[f] = false;
+}
+
+int hud_shows(int field, int value)
+{
+    return valid[field] && shown[field] == value;
+}
+
+void hud_set(int field, int value)
+{
+    if (hud_shows(field, value)) return;
+
+    const HudField* hf = &fields[field];
+    char text[16];
+    if (hf->flag)
+        snprintf(text, sizeof(text), "%-*s", hf->width, value ? hf->label : "");
+    else
+        snprintf(text, sizeof(text), "%s%-*d", hf->label,
+                 hf->width - (int) strlen(hf->label), value);
+    text[(int) hf->width] = 0; // a value too wide is cut off
+    draw_text(hf->x, hf->y, text, hf->color, BLACK, 1);
+
+    shown[field] = value;
+    valid[field] = true;
+}
@@ -0,0 +1,45 @@
+//=================================================================
+// The HUD header file.
+//
+// Copyright 2023 Georgia Tech. All rights reserved.
+// The materials provided by the instructor in this course are for
+// the use of the students currently enrolled in the course.
+// Copyrighted course materials may not be further disseminated.
+// This file must NOT be made publicly available anywhere.
+//==================================================================
+
+#ifndef HUD_H
+#define HUD_H
+
+/*
+The status text in the bars above and below the map. Each field remembers
+the value it last drew and has its own small rectangle, so hud_set() only
+sends the fields whose value changed, and nothing at all on most frames.
+*/
+
+// HUD fields, for hud_set
+#define HUD_X       0   // Player x
+#define HUD_Y       1   // Player y
+#define HUD_MAP     2   // Active map index
+#define HUD_KEY     3   // Nonzero once the player has the key
+#define HUD_RAMBLIN 4   // Nonzero while walking through walls
+#define NUM_HUD_FIELDS 5
+
+/**
+ * Forgets what every field shows, so the next hud_set of each draws it.
+ * Call when the screen has been cleared or drawn over.
+ */
+void hud_invalidate();
+
+/**
+ * Sets a field to value, redrawing it if that differs from what it shows.
+ */
+void hud_set(int field, int value);
+
+/**
+ * Returns nonzero if the field already shows value on the screen, so
+ * hud_set would draw nothing.
+ */
+int hud_shows(int field, int value);
+
+#endif // HUD_H
@@ -15,6 +15,14 @@
 #include "map.h"
 #include "graphics.h"
 #include "speech.h"
+#include "worldgen.h"
+#include "save.h"
+#include "memory.h"
+#include "console.h"
+#include "fov.h"
+#include "trigger.h"
+#include "frame.h"
+#include "hud.h"
 #include <math.h>
 
 #define CITY_HIT_MARGIN 1
@@ -22,6 +30,7 @@
 
 // Helper function declarations
 void playSound(char* wav);
+void draw_game(int init);
 
 
 /////////////////////////
@@ -69,9 +78,15 @@ struct {
 
 int get_action(GameInputs inputs)
 {
+    // The menu button saves, so it acts once per press, not every frame it
+    // is held
+    static int menu_was_down = false;
+    int menu_pressed = inputs.b3 && !menu_was_down;
+    menu_was_down = inputs.b3;
+
     // 1. Check your action and menu button inputs and return the corresponding action value
     if (inputs.b3) {
-        return MENU_BUTTON;
+        return menu_pressed ? MENU_BUTTON : NO_ACTION;
     } else if (inputs.b2) {
         return ACTION_BUTTON;
     } else if (inputs.ns_down) {
@@ -137,31 +152,26 @@ int update_game(int action)
 
     switch(action)
     {
-        MapItem* currItem;
         case GO_UP:
-            currItem = get_north(Player.x, Player.y);
-            if (currItem->walkable || Player.ramblin) {
+            if (map_walkable(Player.x, Player.y-1) || Player.ramblin) {
                 Player.y--; // moves up if walkable
             }
             break;
             
         case GO_LEFT:
-            currItem = get_west(Player.x, Player.y);
-            if (currItem->walkable || Player.ramblin) {
+            if (map_walkable(Player.x-1, Player.y) || Player.ramblin) {
                 Player.x--; // moves up if walkable
             }
             break;
             
         case GO_DOWN:
-            currItem = get_south(Player.x, Player.y);
-            if (currItem->walkable || Player.ramblin) {
+            if (map_walkable(Player.x, Player.y+1) || Player.ramblin) {
                 Player.y++; // moves up if walkable
             }
             break;
             
         case GO_RIGHT:
-            currItem = get_east(Player.x, Player.y);
-            if (currItem->walkable || Player.ramblin) {
+            if (map_walkable(Player.x+1, Player.y) || Player.ramblin) {
                 Player.x++; // moves up if walkable
             }
             break;
@@ -176,81 +186,131 @@ int update_game(int action)
             break;
 
 
-        case ACTION_BUTTON:
-
-            // 1. Check if near NPC, 
-            if (get_south(Player.px, Player.py)->type == NPC || get_north(Player.px, Player.py)->type == NPC ||
-            get_east(Player.px, Player.py)->type == NPC || get_west(Player.px, Player.py)->type == NPC) {
-                if (!Player.talked_to_npc) {
-                    // give quest
-                    speech("SIRE! Please, I ", "need YOUR help.");
-                    speech("Go to the cave", "there! Slay buzz!");
-                    speech("He HATES water!", "It...changes him");
-                    Player.talked_to_npc = true;
-                } else if (Player.slain_buzz) { // buzz is already slain
-                    speech("You did it! HOW?", "No matter how.");
-                    speech("You saved us!", "Here is the key!");
-                    speech("It will free you!", "You deserve this.");
-                    Player.has_key = true; // give player key
-                } else { // buzz not slain but already talked to NPC
-                    speech("The cave is not ", "far, go south!");
-                    speech("Find him! Hurry!", "Make haste!");
-                }
-                return FULL_DRAW; // return FULL_DRAW to redraw the scene
+        case MENU_BUTTON:
+            // Save the game; it is picked up again at the next boot
+            if (save_game(&Player, sizeof(Player)) > 0) {
+                speech("Game saved.", "");
+            } else {
+                speech("Could not save", "the game.");
             }
-            
+            return FULL_DRAW;
 
-            // 2. Check if near a door
-            if (get_south(Player.x, Player.y)->type == DOOR || get_north(Player.x, Player.y)->type == DOOR ||
-            get_east(Player.x, Player.y)->type == DOOR || get_west(Player.x, Player.y)->type == DOOR) {
-                if (Player.has_key) {
-                    speech("Your time is now,", "worthy one, rise.");
-                    return GAME_OVER;
-                } else {
-                    speech("Only worthy to ", "pass. Find Diamond.");
-                    return FULL_DRAW;
-                }
-            }
-            
 
+        case ACTION_BUTTON:
+        {
+            // Whatever the player stands on or next to decides what
+            // happens, see register_triggers
+            int result = trigger_fire(Player.x, Player.y);
+            if (result != TRIGGER_NONE) return result;
+            break;
+        }
+    }
+    
+    return NO_RESULT;
+}
 
-            // 3. Check if on Buzz's cave
-            if (get_here(Player.x, Player.y)->type == CAVE) {
-                if (Player.talked_to_npc) {
-                    // start speech bubble to fight buzz
-                    Player.x = 8;
-                    Player.y = 14; // set the players coordinates for the small map
-                    set_active_map(1);
-                    speech("BUZZEZZZZZZEZZ", "MUAHAHAHAAHAHH");
-                    speech("I must find the", "powerful spell!");
-                    return FULL_DRAW;
-                }
-            }
 
 
-            // 4. Check if on a stairs
-            if (get_here(Player.x, Player.y)->type == STAIRS) {
-                Player.x = 5;
-                Player.y = 5;
-                set_active_map(0);
-                return FULL_DRAW;
-            }
+/////////////////////////
+// Triggers
+/////////////////////////
 
+/**
+ * Moves the player to the target of stairs or a cave (see StairsData).
+ */
+static void travel(MapItem* item)
+{
+    StairsData* target = (StairsData*) item->data;
+    Player.x = target->tx;
+    Player.y = target->ty;
+    set_active_map(target->tm);
+}
 
-            // 5. Check if at the right spell to end the game
-            if (get_here(Player.x, Player.y)->type == WATER) {
-                // declare buzz is defeated using speech bubble
-                Player.slain_buzz = true;
-                Player.game_solved = true;
-                add_slain_buzz(8, 8);
-                speech("    *SWOOSH*", "     *THUMP*");
-                speech("I... did it,", "that was easy.");
-                return FULL_DRAW;
-            }
-            break;
+/**
+ * Trigger for the NPC: hands out the quest, then the key once Buzz is slain.
+ */
+static int talk_to_npc(MapItem*, int, int)
+{
+    if (!Player.talked_to_npc) {
+        // give quest
+        speech("SIRE! Please, I ", "need YOUR help.");
+        speech("Go to the cave", "there! Slay buzz!");
+        speech("He HATES water!", "It...changes him");
+        Player.talked_to_npc = true;
+    } else if (Player.slain_buzz) { // buzz is already slain
+        speech("You did it! HOW?", "No matter how.");
+        speech("You saved us!", "Here is the key!");
+        speech("It will free you!", "You deserve this.");
+        Player.has_key = true; // give player key
+    } else { // buzz not slain but already talked to NPC
+        speech("The cave is not ", "far, go south!");
+        speech("Find him! Hurry!", "Make haste!");
     }
-    
-    return NO_RESULT;
+    return FULL_DRAW; // return FULL_DRAW to redraw the scene
+}
+
+/**
+ * Trigger for the door: the key wins the game.
+ */
+static int open_door(MapItem*, int, int)
+{
+    if (Player.has_key) {
+        speech("Your time is now,", "worthy one, rise.");
+        return GAME_OVER;
+    }
+    speech("Only worthy to ", "pass. Find Diamond.");
+    return FULL_DRAW;
+}
+
+/**
+ * Trigger for Buzz's cave: leads in once the NPC has asked for help.
+ */
+static int enter_cave(MapItem* item, int, int)
+{
+    if (!Player.talked_to_npc) return NO_RESULT;
+    travel(item);
+    speech("BUZZEZZZZZZEZZ", "MUAHAHAHAAHAHH");
+    speech("I must find the", "powerful spell!");
+    return FULL_DRAW;
+}
+
+/**
+ * Trigger for stairs: leads back out.
+ */
+static int climb_stairs(MapItem* item, int, int)
+{
+    travel(item);
+    return FULL_DRAW;
+}
+
+/**
+ * Trigger for the water spell, the one that defeats Buzz.
+ */
+static int cast_water(MapItem*, int x, int y)
+{
+    Player.slain_buzz = true;
+    Player.game_solved = true;
+    int bx, by;
+    if (map_nearest(ENEMY, x, y, &bx, &by)) add_slain_buzz(bx, by); // wherever he stands
+    set_tint(TINT_FLASH); // flash the screen as the spell hits
+    draw_game(false);     // the tint is part of each cell's look, so every cell redraws
+    set_tint(TINT_NONE);
+    speech("    *SWOOSH*", "     *THUMP*");
+    speech("I... did it,", "that was easy.");
+    return FULL_DRAW;
+}
+
+/**
+ * Registers what the action button does next to or on each kind of item.
+ * The order is the priority when more than one applies.
+ */
+void register_triggers()
+{
+    trigger_register(NPC,    TRIGGER_ADJACENT, talk_to_npc);
+    trigger_register(DOOR,   TRIGGER_ADJACENT, open_door);
+    trigger_register(CAVE,   TRIGGER_HERE,     enter_cave);
+    trigger_register(STAIRS, TRIGGER_HERE,     climb_stairs);
+    trigger_register(WATER,  TRIGGER_HERE,     cast_water);
 }
 
 
@@ -260,83 +320,288 @@ int update_game(int action)
 // Draw Game
 /////////////////////////
 
+/**
+ * Returns true if (x,y) is inside the active map.
+ */
+static bool in_map(int x, int y)
+{
+    return x >= 0 && y >= 0 && x < map_width() && y < map_height();
+}
+
+// Screen position of the top left pixel of view cell (i,j), where (0,0) is
+// the player and i runs -5..5, j -4..4
+#define CELL_U(i) (((i)+5)*11 + 3)
+#define CELL_V(j) (((j)+4)*11 + 15)
+
+// CellLook.count of a cell whose contents on the LCD are unknown
+#define LOOK_UNKNOWN 0xFF
+
+/**
+ * What one view cell looks like: the DrawFuncs that paint it, bottom first,
+ * and what decides their image besides the DrawFunc itself. Two cells with
+ * equal looks are the same pixels.
+ */
+// Most DrawFuncs in one look: the black under it, the layers and the player
+#define LOOK_MAX_DRAWS (NUM_LAYERS + 2)
+
+struct CellLook {
+    DrawFunc draw[LOOK_MAX_DRAWS];          // Painted in order
+    unsigned char frame[LOOK_MAX_DRAWS];    // Animation frame, or key for the player
+    unsigned char count;                // DrawFuncs used, or LOOK_UNKNOWN
+    unsigned char tint;                 // TINT_* they were drawn with
+};
+
+// What each view cell shows on the LCD now, indexed [j+4][i+5]
+static CellLook shadow[9][11] AHBSRAM1;
+
+// What each view cell should show this frame, indexed like shadow
+static CellLook want[9][11] AHBSRAM1;
+
+// Bit per animation (see anim_tick) some view cell showed when last drawn
+static int anim_shown;
+
+/**
+ * DrawFunc for the player, so it fits in a CellLook.
+ */
+static void draw_hero(int u, int v)
+{
+    draw_player(u, v, Player.has_key);
+}
+
+/**
+ * Adds a DrawFunc on top of a look. One that fills the whole tile with a
+ * colour hides everything under it, so that is dropped.
+ */
+static void look_add(CellLook* look, DrawFunc draw, int frame)
+{
+    if (tile_fill(draw) >= 0) look->count = 0;
+    look->draw[look->count] = draw;
+    look->frame[look->count] = frame;
+    look->count++;
+}
+
+/**
+ * Works out what view cell (i,j) should look like now. Sprites have
+ * see-through pixels, so the layers and the player are painted over each
+ * other, bottom first, on top of black.
+ */
+static void cell_look(int i, int j, CellLook* look)
+{
+    int x = i + Player.x;
+    int y = j + Player.y;
+
+    look->count = 0;
+    look->tint = get_tint();
+    if (!in_map(x, y)) // out of bounds, draw the walls
+    {
+        look_add(look, draw_wall, 0);
+        return;
+    }
+    look_add(look, draw_nothing, 0);
+    if (fov_visible(x, y))
+    {
+        // Paint the layers from the ground up. Empty and erased layers are
+        // skipped.
+        MapItem* stack[NUM_LAYERS];
+        map_stack(x, y, stack);
+        for (int layer = 0; layer < NUM_LAYERS; layer++)
+        {
+            if (stack[layer] && stack[layer]->type != CLEAR)
+                look_add(look, stack[layer]->draw, anim_image(stack[layer]->draw));
+        }
+    }
+    if (i == 0 && j == 0) // the player stands on top
+        look_add(look, draw_hero, Player.has_key);
+}
+
+/**
+ * Returns true if two looks are the same pixels.
+ */
+static bool same_look(const CellLook* a, const CellLook* b)
+{
+    if (a->count != b->count || a->tint != b->tint) return false;
+    for (int n = 0; n < a->count; n++)
+    {
+        if (a->draw[n] != b->draw[n] || a->frame[n] != b->frame[n]) return false;
+    }
+    return true;
+}
+
+#ifdef F_SCROLL
+/**
+ * Moves the shadow along with a one tile scroll by (sx,sy): cell (i,j) now
+ * shows what cell (i+sx, j+sy) did. Cells scrolled into view are unknown.
+ */
+static void scroll_shadow(int sx, int sy)
+{
+    if (sx)
+    {
+        for (int j = 0; j < 9; j++)
+        {
+            memmove(&shadow[j][sx < 0], &shadow[j][sx > 0], 10 * sizeof(CellLook));
+            shadow[j][sx > 0 ? 10 : 0].count = LOOK_UNKNOWN;
+        }
+    }
+    if (sy)
+    {
+        memmove(shadow[sy < 0], shadow[sy > 0], 8 * sizeof(shadow[0]));
+        for (int i = 0; i < 11; i++) shadow[sy > 0 ? 8 : 0][i].count = LOOK_UNKNOWN;
+    }
+}
+#endif
+
+/**
+ * Fills values with what each HUD field should show, indexed by HUD_*.
+ */
+static void hud_values(int* values)
+{
+    values[HUD_X] = Player.x;
+    values[HUD_Y] = Player.y;
+    values[HUD_MAP] = get_active_map_index();
+    values[HUD_KEY] = Player.has_key;
+    values[HUD_RAMBLIN] = Player.ramblin;
+}
+
+/**
+ * Returns true if a HUD field no longer shows what it should, so the frame
+ * needs drawing even though nothing on the map changed.
+ */
+static bool hud_stale()
+{
+    int values[NUM_HUD_FIELDS];
+    hud_values(values);
+    for (int f = 0; f < NUM_HUD_FIELDS; f++)
+        if (!hud_shows(f, values[f])) return true;
+    return false;
+}
+
 /**
  * Entry point for frame drawing. This should be called once per iteration of
  * the game loop. This draws all tiles on the screen, followed by the status 
  * bars. Unless init is nonzero, this function will optimize drawing by only 
  * drawing tiles that have changed from the previous frame.
+ *
+ * What each cell shows is kept in a shadow of the screen, and a cell is only
+ * drawn when what it should show differs, so a frame where nothing changed
+ * sends no tile commands at all. Changed cells of one solid colour (empty
+ * or wall) are merged with their neighbours of the same colour into the
+ * largest rectangles that fit, and each is filled with one command. Each run
+ * of other changed cells in a row is composed in RAM (see gfx_begin) and
+ * sent with one blit. With F_SCROLL, when the player takes one step, the
+ * LCD first scrolls the view by a tile if its firmware can (see gfx_scroll),
+ * so only the row or column that comes into view, the player and cells that
+ * changed need drawing. The status bars are only drawn on init, and the HUD
+ * only redraws fields whose value changed.
  */
 void draw_game(int init)
 {
     // Draw game border first
     if(init) draw_border();
-    
-    // Iterate over all visible map tiles
-    for (int i = -5; i <= 5; i++) // Iterate over columns of tiles
+
+    // Work out what the player can see; a no-op unless they moved
+    fov_update(Player.x, Player.y);
+
+#ifdef F_SCROLL
+    // Scroll the view along with a single step
+    int sx = Player.x - Player.px;
+    int sy = Player.y - Player.py;
+    if (!init && abs(sx) + abs(sy) == 1 && gfx_can_scroll())
     {
-        for (int j = -4; j <= 4; j++) // Iterate over one column of tiles
+        if (gfx_scroll(CELL_U(-5), CELL_V(-4), 11*11, 9*11, -sx*11, -sy*11))
+            scroll_shadow(sx, sy);
+        else
+            init = true; // part of the view may have moved, redraw every tile
+    }
+#endif
+    if (init) // the screen may hold anything
+    {
+        for (int j = 0; j < 9; j++)
+            for (int i = 0; i < 11; i++) shadow[j][i].count = LOOK_UNKNOWN;
+    }
+
+    // Work out which cells changed, and which animations are in view
+    bool todo[9][11];
+    anim_shown = 0;
+    for (int j = 0; j < 9; j++)
+    {
+        for (int i = 0; i < 11; i++)
         {
-            // Here, we have a given (i,j)
-            
-            // Compute the current map (x,y) of this tile
-            int x = i + Player.x;
-            int y = j + Player.y;
-            
-            // Compute the previous map (px, py) of this tile
-            int px = i + Player.px;
-            int py = j + Player.py;
-                        
-            // Compute u,v coordinates for drawing
-            int u = (i+5)*11 + 3;
-            int v = (j+4)*11 + 15;
-            
-            // Figure out what to draw
-            DrawFunc draw = NULL;
-//            if (init && i == 0 && j == 0) // Only draw the player on init
-            if ( i == 0 && j == 0) // always draw the player
+            cell_look(i - 5, j - 4, &want[j][i]);
+            todo[j][i] = !same_look(&want[j][i], &shadow[j][i]);
+            for (int n = 0; n < want[j][i].count; n++)
+                anim_shown |= anim_bit(want[j][i].draw[n]);
+        }
+    }
+
+    // Fill changed solid cells as rectangles. Each grows right, then down,
+    // over cells that should be the same colour, whether or not they
+    // changed; repainting one with the colour it has is harmless.
+    for (int j = 0; j < 9; j++)
+    {
+        for (int i = 0; i < 11; i++)
+        {
+            int color = tile_fill(want[j][i].draw[0]);
+            if (!todo[j][i] || want[j][i].count != 1 || color < 0) continue;
+
+            int i2 = i + 1, j2 = j + 1; // Rectangle is [i,i2) x [j,j2)
+            while (i2 < 11 && want[j][i2].count == 1 &&
+                   tile_fill(want[j][i2].draw[0]) == color) i2++;
+            for (; j2 < 9; j2++)
             {
-                draw_player(u, v, Player.has_key);
-                continue;
+                int k = i;
+                while (k < i2 && want[j2][k].count == 1 &&
+                       tile_fill(want[j2][k].draw[0]) == color) k++;
+                if (k < i2) break;
             }
-            else if (x >= 0 && y >= 0 && x < map_width() && y < map_height()) // Current (i,j) in the map
+
+            gfx_fill(CELL_U(i-5), CELL_V(j-4), CELL_U(i2-5) - 1, CELL_V(j2-4) - 1, color);
+            for (int y = j; y < j2; y++)
             {
-                MapItem* curr_item = get_here(x, y);
-                MapItem* prev_item = get_here(px, py);
-                if (init || curr_item != prev_item) // Only draw if they're different
-                {
-                    if (curr_item) // There's something here! Draw it
-                    {
-                        draw = curr_item->draw;
-                    }
-                    else // There used to be something, but now there isn't
-                    {
-                        draw = draw_nothing;
-                    }
-                }
-                else if (curr_item && curr_item->type == CLEAR)
+                for (int x = i; x < i2; x++)
                 {
-                    // This is a special case for erasing things like doors.
-                    draw = curr_item->draw; // i.e. draw_nothing
+                    todo[y][x] = false;
+                    shadow[y][x] = want[y][x];
                 }
             }
-            else if (init) // If doing a full draw, but we're out of bounds, draw the walls.
+        }
+    }
+
+    // Blit each run of the other changed cells in a row
+    for (int j = 0; j < 9; j++)
+    {
+        for (int i = 0; i < 11; i++)
+        {
+            if (!todo[j][i]) continue;
+            int i2 = i + 1; // Run is [i,i2)
+            while (i2 < 11 && todo[j][i2]) i2++;
+
+            gfx_begin(CELL_U(i-5), CELL_V(j-4), (i2 - i) * 11, 11);
+            for (; i < i2; i++)
             {
-                draw = draw_wall;
+                CellLook* look = &want[j][i];
+                for (int n = 0; n < look->count; n++)
+                    look->draw[n](CELL_U(i-5), CELL_V(j-4));
+                shadow[j][i] = *look;
             }
-
-            // Actually draw the tile
-            if (draw) draw(u, v);
+            gfx_flush();
         }
     }
 
-    // Draw status bars    
-    draw_upper_status();
-    draw_lower_status();
+    // Draw status bars, then the HUD fields that changed
+    if (init)
+    {
+        draw_upper_status();
+        draw_lower_status();
+        hud_invalidate();
+    }
+    int values[NUM_HUD_FIELDS];
+    hud_values(values);
+    for (int f = 0; f < NUM_HUD_FIELDS; f++) hud_set(f, values[f]);
 }
 
 void draw_game_over() {
     uLCD.filled_rectangle(0, 0, 300, 300, DGREY); // Top
-    uLCD.text_string("GAME OVER!", 4, 4, FONT_12X16, WHITE);
+    draw_text(4, 56, "GAME OVER!", WHITE, DGREY, 2);
 }
 
 
@@ -352,52 +617,45 @@ int cb_loc[2] = {5,20}; //Location of the center of the cave
 /**
  * Initialize the main world map. Add walls around the edges, interior chambers,
  * and plants in the background so you can see motion.
+ * This is the map's builder: the registry calls it with the map active.
  */
 void init_main_map()
 {
-    //Initialize and sets current map to the first map
-    Map* map = set_active_map(0);
 
     /////////////////////////
     //Initial Environmnet
     /////////////////////////
 
     //Adding random plants
-    pc.printf("Adding Plants!\r\n");
     for(int i = map_width() + 3; i < map_area(); i += 39)
     {
         add_plant(i % map_width(), i / map_width());
     }
 
     //Adding other plants.
-    pc.printf("Adding Alternate Plants!\r\n");
     for(int i = map_width() + 7; i < map_area(); i += 39)
     {
         add_other_plant(i % map_width(), i / map_width());
     }
 
     //Adding wall borders 
-    pc.printf("Adding walls!\r\n");
     add_wall(0,              0,              HORIZONTAL, map_width());
     add_wall(0,              map_height()-1, HORIZONTAL, map_width());
     add_wall(0,              0,              VERTICAL,   map_height());
     add_wall(map_width()-1,  0,              VERTICAL,   map_height());
     
     //Adding extra chamber borders 
-    pc.printf("Add extra chamber\r\n");
     add_wall(30, 0, VERTICAL, 10);
     add_wall(30, 10, HORIZONTAL, 10);
     add_wall(39, 0, VERTICAL, 10);
     add_door(33, 10, HORIZONTAL, 4);
 
     //Adding extra cave to Buzz's evil lair
-    pc.printf("Add cave\r\n");
-    add_cave(cb_loc[0],cb_loc[1],1,1,5,5);      //Cave is set as a 4x4 block to be bigger
-    add_cave(cb_loc[0]+1,cb_loc[1],2,1,5,5);
-    add_cave(cb_loc[0],cb_loc[1]+1,3,1,5,5);
-    add_cave(cb_loc[0]+1,cb_loc[1]+1,4,1,5,5);
-
-    pc.printf("Initial environment completed\r\n");
+    // Each tile leads to the bottom of Buzz's cave (map 1)
+    add_cave(cb_loc[0],cb_loc[1],1,1,8,14);      //Cave is set as a 4x4 block to be bigger
+    add_cave(cb_loc[0]+1,cb_loc[1],2,1,8,14);
+    add_cave(cb_loc[0],cb_loc[1]+1,3,1,8,14);
+    add_cave(cb_loc[0]+1,cb_loc[1]+1,4,1,8,14);
 
     /////////////////////////////////
     // Characters and Items for the map
@@ -406,9 +664,8 @@ void init_main_map()
     // Add NPC
     add_npc(10, 5);  //NPC is initialized to (x,y) = 10, 5. Feel free to move him around
 
-    //Prints out map
-    print_map();
-       pc.printf("Initial environment completed\r\n");
+    // No serial output here: the registry reruns this whenever the map is
+    // rebuilt during play. The console "map" command dumps it on demand.
 }
 
 
@@ -417,64 +674,112 @@ void init_main_map()
 
 
 
+/**
+ * Initialize Buzz's cave. This is the map's builder: the registry calls it
+ * with the map active.
+ */
 void init_small_map()
 {
-    //Sets current map to the second map
-    set_active_map(1);
 
     //Adding wall borders 
-    pc.printf("Adding walls!\r\n");
     add_wall(0,              0,              HORIZONTAL, 16);
     add_wall(0,              16-1, HORIZONTAL, 16);
     add_wall(0,              0,              VERTICAL,   16);
     add_wall(16-1,  0,              VERTICAL,   16);
 
     // 2. Add your three spells at different locations
-    pc.printf("Adding spells!\r\n");
     add_water(4, 8);
     add_fire(12, 8);
     add_earth(8, 12);
 
     // 3. Add Evil Buzz at the center of the map
-    pc.printf("Adding buzz!\r\n");
     add_buzz(8,8);
 
-    // Add stairs back to main (map 0)
-    pc.printf("Adding stairs!\r\n");
-    add_stairs(4, 6, 0, cb_loc[0], cb_loc[1]);
+    // Add stairs back to main (map 0), just below the cave
+    add_stairs(4, 6, 0, cb_loc[0], cb_loc[1]+2);
     
 }
 
 
 /**
- * Program entry point! This is where it all begins.
- * This function orchestrates all the parts of the game. Most of your
- * implementation should be elsewhere - this holds the game loop, and should
- * read like a road map for the rest of the code.
+ * Registers the maps, dropping any built before. Each one is built the first
+ * time it is activated.
  */
-int main()
+void register_maps()
 {
-    // First things first: initialize hardware
-    ASSERT_P(hardware_init() == ERROR_NONE, "Hardware init failed!");
-
-    // Initialize the maps
     maps_init();
-    init_main_map();
-    init_small_map();
-    
-    // Initialize game state
+    map_register(50, 50, init_main_map); // map 0
+    map_register(16, 16, init_small_map); // map 1, Buzz's cave
+}
+
+/**
+ * Sets up the maps and player for a game from the start.
+ */
+void new_game()
+{
+    register_maps(); // a failed load may have patched some
+#ifdef WORLDGEN_STRESS
+    // Benchmark build: start on a generated map WORLDGEN_STRESS times the
+    // main map's width and height instead of the hand-made level.
+    int stress_map = map_register(50 * WORLDGEN_STRESS, 50 * WORLDGEN_STRESS, worldgen_builder);
+    map_set_budget(0x7FFFFFFF);
+    set_active_map(stress_map);
+    worldgen_spawn(&Player.x, &Player.y);
+#else
     set_active_map(0);
     Player.x = Player.y = 5;
+#endif
     Player.has_key = false;
     Player.game_solved = false;
     Player.talked_to_npc = false;
     Player.slain_buzz = false;
     Player.ramblin = false;
+}
+
+/**
+ * Program entry point! This is where it all begins.
+ * This function orchestrates all the parts of the game. Most of your
+ * implementation should be elsewhere - this holds the game loop, and should
+ * read like a road map for the rest of the code.
+ */
+int main()
+{
+    // First things first: initialize hardware
+    ASSERT_P(hardware_init() == ERROR_NONE, "Hardware init failed!");
+
+    fov_init();
+    fov_set_fog(1, true); // the cave is dark
+    register_triggers();
+    frame_init();
+
+    // Resume from the last save, unless button 1 is held at boot to start
+    // a new game
+    int resumed = false;
+#ifndef WORLDGEN_STRESS
+    if (read_inputs().b1) {
+        delete_save();
+    } else {
+        register_maps();
+        resumed = load_game(&Player, sizeof(Player));
+    }
+#endif
+    if (resumed) {
+        Player.px = Player.x;
+        Player.py = Player.y;
+    } else {
+        new_game();
+    }
+
+#ifdef F_DEBUG
+    mem_sample();
+    mem_report();
+#endif
 
     // Initial drawing
     draw_game(true);
 
     // Main game loop
+    int frame = 0;
     while(1)
     {
 
@@ -482,28 +787,38 @@ int main()
         // TODO: Implement 
         ////////////////////////////////
 
-        // Timer to measure game update speed
-        Timer t; t.start();
+        // Time this frame's work against the frame budget
+        frame_start();
         
         GameInputs temp = read_inputs();
         int ac = get_action(temp);
         int result = update_game(ac);  // Set this variable "result" for the resulting state after update game
+        if (result != NO_RESULT || Player.x != Player.px || Player.y != Player.py)
+            frame_changed();
+        if (hud_stale()) frame_changed(); // e.g. ramblin toggled in place
 
         // 3b. Check for game over based on update game result
         if (result == GAME_OVER) {
+            // The game is won, so the next boot starts a new one
+            delete_save();
             // switch to end game screen
             draw_game_over();
             break;
         }
-        // 4. Draw screen to uLCD
+        // 4. Draw screen to uLCD, unless nothing changed
         bool full_draw = false;
         if (result == FULL_DRAW) full_draw = true;
-        draw_game(full_draw);
+        if (anim_tick() & anim_shown) frame_changed(); // a tile in view animates
+        if (frame_render_due()) draw_game(full_draw);
+
+        // Serve the debug console without blocking
+        console_poll();
+
+        // Track the heap high-water marks now and then
+        if (++frame % MEM_SAMPLE_FRAMES == 0) mem_sample();
         
         // 5. Frame delay
-        t.stop();
-        int dt = t.read_ms();
-        if (dt < 100) wait_ms(100 - dt);
+        frame_end();
     }
 }
 
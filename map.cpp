@@ -14,13 +14,46 @@
 #include "hash_table.h"
 
 /**
- * The Map structure. This holds a HashTable for all the MapItems, along with
- * values for the width and height of the Map.
+ * Positions of every interactive item of one type on a map. The array grows
+ * on demand and is kept unordered; removal swaps the last entry in.
+ */
+struct TypeIndex {
+    MapPos* pos;      // Positions of the items
+    int count;        // Number of positions in use
+    int cap;          // Allocated capacity of pos
+};
+
+// Item types tracked by the spatial index, in index slot order
+#define NUM_INDEXED 6
+static const int INDEXED_TYPES[NUM_INDEXED] = {NPC, DOOR, STAIRS, CAVE, WATER, ENEMY};
+
+/**
+ * The Map structure. This holds the storage for each layer of MapItems, along
+ * with values for the width and height of the Map.
+ *
+ * The ground never changes once a level is built and covers much of the map,
+ * so it is a dense array of one byte per tile indexing GROUND_TILES. The
+ * object and overlay layers are sparse and stay hashed.
  */
 struct Map {
-    HashTable* items; // Hashtables for all items of the map
-    int w, h;         // Map dimensions
+    unsigned char* ground; // Ground tile ids, w*h of them, column-major like XY_KEY
+    HashTable* items;      // Hashtable for the object layer
+    HashTable* overlay;    // Hashtable for the overlay layer
+    int w, h;              // Map dimensions
     int index;        // Index of map (tells if its the first map or second map)
+    TypeIndex types[NUM_INDEXED]; // Spatial index of interactive items
+
+    // Registry bookkeeping. The layers above only exist while resident.
+    MapBuilder build;        // Populates the map on first activation
+    int resident;            // Nonzero while the layers are allocated
+    int dirty;               // Changed since it was built
+    unsigned last_used;      // Activation stamp for LRU eviction
+    int nentries;            // Hash entries over both hashed layers
+    int nitems;              // Heap MapItems over both hashed layers
+    int ndata;               // StairsData blocks owned by those items
+    int ntypes[NUM_TYPES];   // Heap MapItems of each type
+    unsigned char* snapshot; // Serialized items while evicted, or NULL
+    int snapshot_size;       // Bytes in snapshot
 };
 
 ///////////////////////
@@ -28,9 +61,25 @@ struct Map {
 ///////////////////////
 
 #define MHF_NBUCKETS 97     //  Hashing value
-#define NUM_MAPS 2          //  You may add more maps here
-static Map maps[NUM_MAPS];  //  Array of maps
+static Map maps[MAX_MAPS + 2]; // Registry of maps, see map_register
+#define SCRATCH_MAP MAX_MAPS  //  Extra slot where map_diff rebuilds a baseline
+#define SCRATCH_COPY (MAX_MAPS + 1) // Extra slot where map_diff reads an evicted map
+static int num_maps;        //  Number of registered maps
 static int active_map;      //  Current active map on screen
+static unsigned use_clock;  //  Bumped on every set_active_map, for LRU
+static int building;        //  Nonzero while a builder or restore fills a map
+static int ram_budget = MAP_RAM_BUDGET; // Bytes resident maps may use
+static MapChangeFunc listeners[MAX_MAP_LISTENERS]; // See map_on_change
+static int num_listeners;
+
+// Estimated size of one HashTableEntry (key, value, next)
+#define HASH_ENTRY_BYTES 12
+
+// Estimated size of a HashTable header (buckets, hash, num_buckets)
+#define HASH_TABLE_BYTES 12
+
+// Bookkeeping the heap adds to every malloc'd block
+#define MALLOC_OVERHEAD 8
 //static int buzzStatus = 1;  //  If the boss is alive or not
 
 
@@ -41,6 +90,31 @@ static const MapItem CLEAR_SENTINEL = {
     .draw = draw_nothing
 };
 
+// Ground tile ids stored in Map.ground
+#define GROUND_NONE         0
+#define GROUND_PLANT        1
+#define GROUND_OTHER_PLANT  2
+#define GROUND_MUD          3
+
+// The shared MapItem for each ground tile id. These live in flash; ground
+// tiles never own any memory of their own.
+static const MapItem GROUND_TILES[] = {
+    {CLEAR, draw_nothing,     true, NULL}, // GROUND_NONE, never returned
+    {PLANT, draw_plant,       true, NULL}, // GROUND_PLANT
+    {PLANT, draw_other_plant, true, NULL}, // GROUND_OTHER_PLANT
+    {MUD,   draw_mud,         true, NULL}, // GROUND_MUD
+};
+#define NUM_GROUND_TILES (int)(sizeof(GROUND_TILES) / sizeof(GROUND_TILES[0]))
+
+// Every DrawFunc a MapItem can have. Snapshots store an item's draw function
+// as its position in this table.
+static const DrawFunc DRAW_FUNCS[] = {
+    draw_nothing, draw_wall, draw_plant, draw_other_plant, draw_mud,
+    draw_door, draw_npc, draw_stairs, draw_cave1, draw_cave2, draw_cave3,
+    draw_cave4, draw_water, draw_fire, draw_earth, draw_buzz
+};
+#define NUM_DRAW_FUNCS (int)(sizeof(DRAW_FUNCS) / sizeof(DRAW_FUNCS[0]))
+
 
 /**
  * The first step in HashTable access for the map is turning the two-dimensional
@@ -62,18 +136,722 @@ unsigned map_hash(unsigned key)
 }
 
 /**
- * Initializes the map, using a hash_table, setting the width and height.
+ * Returns the hashtable holding a hashed layer of the map.
+ */
+static HashTable* layer_table(Map* map, int layer)
+{
+    return (layer == LAYER_OVERLAY) ? map->overlay : map->items;
+}
+
+/**
+ * Returns the item on one layer of the map at (x,y), or NULL if that cell of
+ * the layer is empty or off the map. Erased cells return CLEAR_SENTINEL.
+ */
+static MapItem* layer_item(Map* map, int layer, int x, int y)
+{
+    if (x < 0 || y < 0 || x >= map->w || y >= map->h) return NULL;
+    if (layer == LAYER_GROUND) {
+        unsigned char g = map->ground[x * map->h + y];
+        return g ? (MapItem*) &GROUND_TILES[g] : NULL;
+    }
+    return (MapItem*) getItem(layer_table(map, layer), x * map->h + y);
+}
+
+/**
+ * Returns the topmost item at (x,y), skipping empty and erased cells.
+ */
+static MapItem* top_item(Map* map, int x, int y)
+{
+    for (int layer = NUM_LAYERS - 1; layer >= 0; layer--) {
+        MapItem* it = layer_item(map, layer, x, y);
+        if (it && it->type != CLEAR) return it;
+    }
+    return NULL;
+}
+
+/**
+ * Returns the spatial index slot for an item type, or -1 if that type is
+ * not indexed.
+ */
+static int index_slot(int type)
+{
+    for (int i = 0; i < NUM_INDEXED; i++) {
+        if (INDEXED_TYPES[i] == type) return i;
+    }
+    return -1;
+}
+
+/**
+ * Records an item of the given type at (x,y) in the map's spatial index.
+ */
+static void index_add(Map* map, int type, int x, int y)
+{
+    int slot = index_slot(type);
+    if (slot < 0) return; // not an interactive type
+    TypeIndex* ti = &map->types[slot];
+    if (ti->count == ti->cap) { // grow the position array
+        int cap = ti->cap ? 2 * ti->cap : 4;
+        MapPos* pos = (MapPos*) realloc(ti->pos, cap * sizeof(MapPos));
+        if (pos == NULL) return; // out of memory, item stays unindexed
+        ti->pos = pos;
+        ti->cap = cap;
+    }
+    ti->pos[ti->count].x = x;
+    ti->pos[ti->count].y = y;
+    ti->count++;
+}
+
+/**
+ * Drops the item of the given type at (x,y) from the map's spatial index.
+ */
+static void index_remove(Map* map, int type, int x, int y)
+{
+    int slot = index_slot(type);
+    if (slot < 0) return; // not an interactive type
+    TypeIndex* ti = &map->types[slot];
+    for (int i = 0; i < ti->count; i++) {
+        if (ti->pos[i].x == x && ti->pos[i].y == y) {
+            ti->pos[i] = ti->pos[--ti->count]; // swap the last one in
+            return;
+        }
+    }
+}
+
+/**
+ * Records that (x,y) on the active map changed and tells the listeners.
+ * Changes made while building or restoring a map are not reported.
+ */
+static void map_changed(Map* map, int x, int y)
+{
+    if (building) return;
+    map->dirty = true;
+    for (int i = 0; i < num_listeners; i++) {
+        listeners[i](active_map, x, y);
+    }
+}
+
+/**
+ * Allocates a new MapItem with the given fields.
+ */
+static MapItem* new_item(int type, DrawFunc draw, int walkable, void* data)
+{
+    MapItem* item = (MapItem*) malloc(sizeof(MapItem));
+    item->type = type;
+    item->draw = draw;
+    item->walkable = walkable;
+    item->data = data;
+    return item;
+}
+
+/**
+ * Places item at (x,y) on a hashed layer of the active map. Whatever was
+ * there before is dropped from the spatial index and freed along with its
+ * data. Every change to the map's hashed layers goes through here.
+ */
+static void put_item(int layer, int x, int y, MapItem* item)
+{
+    Map* map = get_active_map();
+    MapItem* old = (MapItem*) insertItem(layer_table(map, layer), XY_KEY(x, y), item);
+    if (old) {
+        index_remove(map, old->type, x, y);
+        if (old != &CLEAR_SENTINEL) { // the sentinel is shared and static
+            if (old->data) {
+                free(old->data);
+                map->ndata--;
+            }
+            map->ntypes[old->type]--;
+            free(old); // If something is already there, free it
+            map->nitems--;
+        }
+    } else {
+        map->nentries++; // a new hash entry
+    }
+    if (item != &CLEAR_SENTINEL) {
+        map->nitems++;
+        map->ntypes[item->type]++;
+        if (item->data) map->ndata++;
+    }
+    index_add(map, item->type, x, y);
+    map_changed(map, x, y);
+}
+
+/**
+ * Sets the ground tile at (x,y) on the active map.
+ */
+static void put_ground(int x, int y, unsigned char g)
+{
+    Map* map = get_active_map();
+    if (x < 0 || y < 0 || x >= map->w || y >= map->h) return;
+    map->ground[x * map->h + y] = g;
+    map_changed(map, x, y);
+}
+
+////////////////////////////////////
+// Map registry
+////////////////////////////////////
+
+/**
+ * Allocates the (empty) layers of a map.
+ */
+static void alloc_layers(Map* map)
+{
+    map->items = createHashTable(map_hash, MHF_NBUCKETS);
+    map->overlay = createHashTable(map_hash, MHF_NBUCKETS);
+    map->ground = (unsigned char*) calloc(map->w * map->h, 1);
+    map->resident = true;
+}
+
+/**
+ * HashVisitor that frees a MapItem and its data.
+ */
+static void free_item(unsigned, void* value, void*)
+{
+    MapItem* item = (MapItem*) value;
+    if (item == &CLEAR_SENTINEL) return; // the sentinel is shared and static
+    if (item->data) free(item->data);
+    free(item);
+}
+
+/**
+ * Frees the layers and spatial index of a map, leaving it non-resident.
+ */
+static void free_layers(Map* map)
+{
+    HashTable* tables[2] = {map->items, map->overlay};
+    for (int t = 0; t < 2; t++) {
+        forEachItem(tables[t], free_item, NULL);
+        clearHashTable(tables[t]);  // values are gone already
+        destroyHashTable(tables[t]); // now only frees the buckets
+    }
+    free(map->ground);
+    for (int i = 0; i < NUM_INDEXED; i++) {
+        free(map->types[i].pos);
+        map->types[i].pos = NULL;
+        map->types[i].count = map->types[i].cap = 0;
+    }
+    map->items = map->overlay = NULL;
+    map->ground = NULL;
+    map->nentries = map->nitems = map->ndata = 0;
+    memset(map->ntypes, 0, sizeof(map->ntypes));
+    map->resident = false;
+}
+
+// Item records. Snapshots and save-game diffs store tiles as records of
+//   u8 layer, u16 x, u16 y, u8 type, u8 draw (DRAW_FUNCS index),
+//   u8 walkable, u8 has_data, then if has_data: i16 tm, tx, ty
+// On the ground layer, type holds the ground tile id and the rest is zero.
+// An erased cell is a record of type CLEAR.
+#define RECORD_BYTES      9
+#define RECORD_DATA_BYTES 6
+
+// Snapshot format. An evicted map keeps only a compact byte string:
+//   u16 record count, then a record per hashed-layer item,
+//   followed by the ground layer run-length encoded as (u8 run, u8 id) pairs.
+//
+// Diff format (see map_diff): records only, up to the end of the buffer, for
+// the hashed-layer items and ground tiles that differ from the baseline.
+
+/**
+ * State threaded through the record visitors.
+ */
+struct RecordWriter {
+    Map* map;            // Map being serialized
+    Map* base;           // Baseline to diff against, or NULL for every item
+    int layer;           // Layer being walked
+    unsigned char* out;  // Write cursor, NULL while only measuring
+    int size;            // Bytes written (or needed) so far
+    int count;           // Records written so far
+    int ok;              // Cleared if an item cannot be serialized
+};
+
+static unsigned char* put_u16(unsigned char* p, int v)
+{
+    p[0] = (v >> 8) & 0xFF;
+    p[1] = v & 0xFF;
+    return p + 2;
+}
+
+static int get_u16(const unsigned char* p)
+{
+    return (p[0] << 8) | p[1];
+}
+
+/**
+ * Returns the position of a draw function in DRAW_FUNCS, or -1.
+ */
+static int draw_index(DrawFunc draw)
+{
+    for (int i = 0; i < NUM_DRAW_FUNCS; i++) {
+        if (DRAW_FUNCS[i] == draw) return i;
+    }
+    return -1;
+}
+
+/**
+ * Returns whether two items would serialize to the same record.
+ */
+static int same_item(const MapItem* a, const MapItem* b)
+{
+    if (a == b) return true;
+    if (a == NULL || b == NULL) return false;
+    if (a->type != b->type || a->draw != b->draw || !a->walkable != !b->walkable)
+        return false;
+    if (a->data == NULL || b->data == NULL) return a->data == b->data;
+    StairsData* da = (StairsData*) a->data;
+    StairsData* db = (StairsData*) b->data;
+    return da->tm == db->tm && da->tx == db->tx && da->ty == db->ty;
+}
+
+/**
+ * Appends one record to rw. Only STAIRS and CAVE items carry data.
+ */
+static void write_record(RecordWriter* rw, int layer, int x, int y, int type,
+                         int draw, int walkable, StairsData* data)
+{
+    if (rw->out) {
+        unsigned char* p = rw->out + rw->size;
+        *p++ = layer;
+        p = put_u16(p, x);
+        p = put_u16(p, y);
+        *p++ = type;
+        *p++ = draw;
+        *p++ = walkable ? 1 : 0;
+        *p++ = data ? 1 : 0;
+        if (data) {
+            p = put_u16(p, data->tm);
+            p = put_u16(p, data->tx);
+            p = put_u16(p, data->ty);
+        }
+    }
+    rw->size += RECORD_BYTES + (data ? RECORD_DATA_BYTES : 0);
+    rw->count++;
+}
+
+/**
+ * HashVisitor that appends the record of one item, unless the baseline has
+ * the same item there.
+ */
+static void record_item(unsigned key, void* value, void* arg)
+{
+    RecordWriter* rw = (RecordWriter*) arg;
+    MapItem* item = (MapItem*) value;
+    if (rw->base &&
+        same_item(item, (MapItem*) getItem(layer_table(rw->base, rw->layer), key)))
+        return; // unchanged since the level was built
+    int draw = draw_index(item->draw);
+    if (draw < 0) {
+        rw->ok = false; // unknown draw function, cannot be rebuilt
+        return;
+    }
+    write_record(rw, rw->layer, key / rw->map->h, key % rw->map->h,
+                 item->type, draw, item->walkable, (StairsData*) item->data);
+}
+
+/**
+ * HashVisitor over the baseline that records a CLEAR for any cell the map
+ * no longer has an entry for.
+ */
+static void record_missing(unsigned key, void*, void* arg)
+{
+    RecordWriter* rw = (RecordWriter*) arg;
+    if (getItem(layer_table(rw->map, rw->layer), key)) return;
+    write_record(rw, rw->layer, key / rw->map->h, key % rw->map->h,
+                 CLEAR, 0, false, NULL);
+}
+
+/**
+ * Appends records for both hashed layers of rw->map: all items, or with a
+ * baseline only those that differ from it.
+ */
+static void record_layers(RecordWriter* rw)
+{
+    for (int layer = LAYER_OBJECT; layer <= LAYER_OVERLAY; layer++) {
+        rw->layer = layer;
+        forEachItem(layer_table(rw->map, layer), record_item, rw);
+        if (rw->base) forEachItem(layer_table(rw->base, layer), record_missing, rw);
+    }
+}
+
+/**
+ * Applies the record at p to the active map and returns the record after it,
+ * or NULL, with nothing applied, if there is no RAM for the item.
+ */
+static const unsigned char* apply_record(const unsigned char* p)
+{
+    int layer = p[0];
+    int x = get_u16(p + 1);
+    int y = get_u16(p + 3);
+    int type = p[5];
+    int draw = p[6] < NUM_DRAW_FUNCS ? p[6] : 0;
+    int walkable = p[7];
+    int has_data = p[8];
+    const unsigned char* d = p + RECORD_BYTES;
+    const unsigned char* next = d + (has_data ? RECORD_DATA_BYTES : 0);
+    if (layer == LAYER_GROUND) {
+        put_ground(x, y, type);
+        return next;
+    }
+    if (type == CLEAR) {
+        put_item(layer, x, y, (MapItem*) &CLEAR_SENTINEL);
+        return next;
+    }
+    StairsData* data = NULL;
+    if (has_data) {
+        data = (StairsData*) malloc(sizeof(StairsData));
+        if (data == NULL) return NULL;
+        data->tm = (short) get_u16(d);
+        data->tx = (short) get_u16(d + 2);
+        data->ty = (short) get_u16(d + 4);
+    }
+    MapItem* item = (MapItem*) malloc(sizeof(MapItem));
+    if (item == NULL) {
+        free(data);
+        return NULL;
+    }
+    item->type = type;
+    item->draw = DRAW_FUNCS[draw];
+    item->walkable = walkable;
+    item->data = data;
+    put_item(layer, x, y, item);
+    return next;
+}
+
+/**
+ * Serializes the items and ground of a map. Runs once to measure (out NULL)
+ * and once to write.
+ */
+static void snap_map(RecordWriter* rw)
+{
+    Map* map = rw->map;
+    rw->size = 2; // record count
+    rw->count = 0;
+    record_layers(rw);
+    if (rw->out) put_u16(rw->out, rw->count);
+
+    int n = map->w * map->h;
+    for (int i = 0; i < n; ) { // ground as (run, id) pairs
+        int run = 1;
+        while (i + run < n && run < 255 && map->ground[i + run] == map->ground[i]) run++;
+        if (rw->out) {
+            rw->out[rw->size] = run;
+            rw->out[rw->size + 1] = map->ground[i];
+        }
+        rw->size += 2;
+        i += run;
+    }
+}
+
+/**
+ * Serializes a map into map->snapshot. Returns false if it cannot be.
+ */
+static int take_snapshot(Map* map)
+{
+    RecordWriter rw = {map, NULL, 0, NULL, 0, 0, true};
+    snap_map(&rw);
+    if (!rw.ok) return false;
+    rw.out = (unsigned char*) malloc(rw.size);
+    if (rw.out == NULL) return false;
+    snap_map(&rw);
+    map->snapshot = rw.out;
+    map->snapshot_size = rw.size;
+    return true;
+}
+
+/**
+ * Fills the layers of map, which must be active, from a snapshot. Returns
+ * false if RAM ran out part way.
+ */
+static int apply_snapshot(Map* map, const unsigned char* snapshot, int size)
+{
+    const unsigned char* p = snapshot;
+    int count = get_u16(p);
+    p += 2;
+    for (int r = 0; r < count; r++) {
+        p = apply_record(p);
+        if (p == NULL) return false;
+    }
+    const unsigned char* end = snapshot + size;
+    for (int i = 0; p < end; p += 2) { // ground runs
+        memset(map->ground + i, p[1], p[0]);
+        i += p[0];
+    }
+    return true;
+}
+
+/**
+ * Rebuilds the layers of the active map from its snapshot, then drops it.
+ */
+static void restore_snapshot(Map* map)
+{
+    int ok = apply_snapshot(map, map->snapshot, map->snapshot_size);
+    ASSERT_P(ok, ERROR_MEH); // no RAM to bring the map back
+    free(map->snapshot);
+    map->snapshot = NULL;
+    map->snapshot_size = 0;
+}
+
+/**
+ * Serializes how a resident map differs from base. Runs once to measure
+ * (out NULL) and once to write.
+ */
+static void diff_map(RecordWriter* rw)
+{
+    Map* map = rw->map;
+    Map* base = rw->base;
+    rw->size = 0;
+    rw->count = 0;
+    record_layers(rw);
+    int n = map->w * map->h;
+    for (int i = 0; i < n; i++) { // ground tiles one by one, few ever change
+        if (map->ground[i] != base->ground[i])
+            write_record(rw, LAYER_GROUND, i / map->h, i % map->h,
+                         map->ground[i], 0, false, NULL);
+    }
+}
+
+/**
+ * Makes a map resident: restores its snapshot if it was evicted after being
+ * changed, otherwise runs its builder. The map must be the active map.
+ */
+static void load_map(Map* map)
+{
+    alloc_layers(map);
+    building = true; // loading is not a change to the map
+    if (map->snapshot) {
+        restore_snapshot(map); // stays dirty: it still differs from a fresh build
+    } else {
+        if (map->build) map->build();
+        map->dirty = false;
+    }
+    building = false;
+}
+
+/**
+ * Builds a copy of map in scratch slot, without touching the map itself,
+ * the active map or the other maps: from the map's snapshot if it is
+ * evicted and from_snapshot is set, otherwise exactly as its builder leaves
+ * it. Free it with free_layers. Returns NULL if RAM ran out restoring the
+ * snapshot.
+ */
+static Map* build_scratch(Map* map, int slot, int from_snapshot)
+{
+    Map* copy = &maps[slot];
+    memset(copy, 0, sizeof(Map));
+    copy->w = map->w;
+    copy->h = map->h;
+    copy->index = slot;
+    copy->build = map->build;
+    int prev = active_map;
+    active_map = slot; // the add_* functions work on the active map
+    alloc_layers(copy);
+    building = true;
+    int ok = true;
+    if (from_snapshot && map->snapshot)
+        ok = apply_snapshot(copy, map->snapshot, map->snapshot_size);
+    else if (copy->build)
+        copy->build();
+    building = false;
+    active_map = prev;
+    if (!ok) free_layers(copy);
+    return ok ? copy : NULL;
+}
+
+/**
+ * Evicts a resident map. A map that changed since it was built is kept as a
+ * snapshot; an unchanged one is simply rebuilt next time. Returns false if
+ * the map could not be evicted.
+ */
+static int evict_map(Map* map)
+{
+    if (map->dirty && !take_snapshot(map)) return false;
+    free_layers(map);
+    return true;
+}
+
+/**
+ * Evicts least recently used inactive maps until the resident maps fit in
+ * the RAM budget, or nothing more can be evicted.
+ */
+static void enforce_budget()
+{
+    while (1) {
+        int total = 0;
+        Map* lru = NULL;
+        for (int i = 0; i < num_maps; i++) {
+            total += map_bytes(i);
+            if (maps[i].resident && i != active_map &&
+                (lru == NULL || maps[i].last_used < lru->last_used))
+                lru = &maps[i];
+        }
+        if (total <= ram_budget || lru == NULL) return;
+        if (!evict_map(lru)) return;
+    }
+}
+
+/**
+ * Resets the map registry. No map storage is allocated until a map is first
+ * activated.
  */
 void maps_init()
 {
-    for (int i = 0; i < NUM_MAPS; i++) {
-        maps[i].items = createHashTable(map_hash, MHF_NBUCKETS);
-        maps[i].h = 50;
-        maps[i].w = 50;
+    for (int i = 0; i < num_maps; i++) {
+        if (maps[i].resident) free_layers(&maps[i]);
+        free(maps[i].snapshot);
     }
-    set_active_map(0);
+    memset(maps, 0, sizeof(maps));
+    num_maps = 0;
+    active_map = 0;
+}
+
+int map_register(int w, int h, MapBuilder build)
+{
+    if (num_maps == MAX_MAPS) return -1; // registry is full
+    Map* map = &maps[num_maps];
+    map->w = w;
+    map->h = h;
+    map->index = num_maps;
+    map->build = build;
+    return num_maps++;
+}
+
+void map_set_budget(int bytes)
+{
+    ram_budget = bytes;
+    enforce_budget();
+}
+
+int map_bytes(int m)
+{
+    MapMemory mem;
+    map_memory(m, &mem);
+    return mem.total;
+}
+
+void map_memory(int m, MapMemory* out)
+{
+    Map* map = &maps[m];
+    memset(out, 0, sizeof(MapMemory));
+    if (!map->resident) {
+        if (map->snapshot) out->snapshot = map->snapshot_size + MALLOC_OVERHEAD;
+        out->total = out->snapshot;
+        return;
+    }
+    out->ground = map->w * map->h + MALLOC_OVERHEAD;
+    out->tables = 2 * (HASH_TABLE_BYTES + MHF_NBUCKETS * sizeof(void*) + 2 * MALLOC_OVERHEAD);
+    out->entries = map->nentries * (HASH_ENTRY_BYTES + MALLOC_OVERHEAD);
+    out->items = map->nitems * (sizeof(MapItem) + MALLOC_OVERHEAD);
+    out->data = map->ndata * (sizeof(StairsData) + MALLOC_OVERHEAD);
+    for (int i = 0; i < NUM_INDEXED; i++) {
+        if (map->types[i].cap)
+            out->index += map->types[i].cap * sizeof(MapPos) + MALLOC_OVERHEAD;
+    }
+    out->total = out->ground + out->tables + out->entries + out->items +
+                 out->data + out->index;
+    out->nentries = map->nentries;
+    out->nitems = map->nitems;
+    out->ndata = map->ndata;
+    memcpy(out->types, map->ntypes, sizeof(out->types));
+}
+
+int map_estimate(int w, int h, int nitems)
+{
+    return w * h + MALLOC_OVERHEAD +
+           2 * (HASH_TABLE_BYTES + MHF_NBUCKETS * sizeof(void*) + 2 * MALLOC_OVERHEAD) +
+           nitems * (HASH_ENTRY_BYTES + sizeof(MapItem) + 2 * MALLOC_OVERHEAD);
+}
+
+int map_count()
+{
+    return num_maps;
 }
 
+int map_resident(int m)
+{
+    return maps[m].resident;
+}
+
+int map_on_change(MapChangeFunc f)
+{
+    if (num_listeners == MAX_MAP_LISTENERS) return false;
+    listeners[num_listeners++] = f;
+    return true;
+}
+
+
+unsigned char* map_diff(int m, int* size)
+{
+    Map* map = &maps[m];
+    *size = 0;
+    if (!map->dirty) return NULL; // never loaded, or still as built
+    // An evicted map is read from a copy of its snapshot, so the active map
+    // stays and nothing else is evicted
+    Map* cur = map->resident ? map : build_scratch(map, SCRATCH_COPY, true);
+    if (cur == NULL) {
+        *size = -1; // no RAM to read it
+        return NULL;
+    }
+    Map* base = build_scratch(map, SCRATCH_MAP, false);
+    RecordWriter rw = {cur, base, 0, NULL, 0, 0, true};
+    diff_map(&rw); // measure
+    unsigned char* out = NULL;
+    if (rw.ok && rw.size > 0) {
+        out = (unsigned char*) malloc(rw.size);
+        if (out) {
+            rw.out = out;
+            diff_map(&rw); // then write, against the same baseline
+        }
+    }
+    free_layers(base);
+    if (cur != map) free_layers(cur);
+    if (!rw.ok || (rw.size > 0 && out == NULL)) *size = -1;
+    else *size = rw.size;
+    return out;
+}
+
+int map_check_diff(int m, const unsigned char* in, int len)
+{
+    if (m < 0 || m >= num_maps) return false;
+    Map* map = &maps[m];
+    const unsigned char* end = in + len;
+    while (in < end) {
+        if (in + RECORD_BYTES > end) return false; // truncated
+        int bytes = RECORD_BYTES + (in[8] ? RECORD_DATA_BYTES : 0);
+        if (in + bytes > end || in[0] >= NUM_LAYERS || in[5] >= NUM_TYPES) return false;
+        if (in[0] == LAYER_GROUND && in[5] >= NUM_GROUND_TILES) return false;
+        if (in[8] && (in[0] == LAYER_GROUND || in[5] == CLEAR)) return false; // no item to own it
+        int x = get_u16(in + 1);
+        int y = get_u16(in + 3);
+        if (x >= map->w || y >= map->h) return false; // not from this map
+        if (in[8]) { // stairs and caves must lead onto a registered map
+            int tm = (short) get_u16(in + RECORD_BYTES);
+            int tx = (short) get_u16(in + RECORD_BYTES + 2);
+            int ty = (short) get_u16(in + RECORD_BYTES + 4);
+            if (tm < 0 || tm >= num_maps || tx < 0 || ty < 0 ||
+                tx >= maps[tm].w || ty >= maps[tm].h) return false;
+        }
+        in += bytes;
+    }
+    return true;
+}
+
+int map_apply_diff(int m, const unsigned char* in, int len)
+{
+    if (!map_check_diff(m, in, len)) return false;
+    Map* map = &maps[m];
+    if (map->resident) free_layers(map); // start over from a fresh build
+    free(map->snapshot);
+    map->snapshot = NULL;
+    map->snapshot_size = 0;
+    map->dirty = false;
+    set_active_map(m);
+
+    const unsigned char* end = in + len;
+    while (in < end) {
+        in = apply_record(in);
+        if (in == NULL) return false; // out of RAM, map is part way
+    }
+    return true;
+}
 
 Map* get_active_map()
 {
@@ -87,28 +865,73 @@ int get_active_map_index()
 
 Map* set_active_map(int m)
 {
+    ASSERT_P(m >= 0 && m < num_maps, ERROR_MEH); // not a registered map
+    Map* map = &maps[m];
     active_map = m;
-    return &maps[m]; // returns pointer to current map
+    map->last_used = ++use_clock;
+    if (!map->resident) load_map(map); // first visit, or evicted
+    enforce_budget();
+    return map; // returns pointer to current map
+}
+
+Map* get_map(int m)
+{
+    return &maps[m];
 }
 
+// Letter for each item type in map dumps, indexed by type
+static const char DUMP_LETTERS[NUM_TYPES + 1] = "WDPAKCN.SVMFEBX";
+
+// Longest line map_dump writes at once; longer rows are split
+#define DUMP_LINE 128
+
 /**
- *  Prints out the map for debugging on the terminal
+ * Returns the dump letter for the topmost item at (x,y).
  */
+static char dump_letter(Map* map, int x, int y)
+{
+    MapItem* item = top_item(map, x, y);
+    return item ? DUMP_LETTERS[item->type] : '.';
+}
 
+/**
+ *  Prints out the map for debugging on the terminal
+ */
 void print_map()
 {
-    // NOTE: As you add more types, you'll need to add more items to this array.
-    char lookup[] = {'W', 'D', 'P', 'A', 'K', 'C', 'N',' ','S'};
+    if (active_map >= MAX_MAPS) return; // a scratch map being built
+    Map* map = get_active_map();
+    pc.printf("map %d (%dx%d)\r\n", active_map, map->w, map->h);
+    map_dump(0, 0, map->w, map->h);
+}
+
+void map_dump(int x, int y, int w, int h)
+{
     Map* map = get_active_map();
-    for(int j = 0; j < map->h; j++)
+    int x1 = x + w < map->w ? x + w : map->w;
+    int y1 = y + h < map->h ? y + h : map->h;
+    if (x < 0) x = 0;
+    if (y < 0) y = 0;
+    char line[DUMP_LINE];
+    for (int j = y; j < y1; j++)
     {
-        for (int i = 0; i < map->w; i++)
+        int n = sprintf(line, "%3d ", j);
+        for (int i = x; i < x1; )
         {
-            MapItem* item = (MapItem*)getItem(map->items, XY_KEY(i, j));
-            if (item) pc.printf("%c", lookup[item->type]);
-            else pc.printf(" ");
+            char c = dump_letter(map, i, j);
+            int run = 1;
+            while (i + run < x1 && dump_letter(map, i + run, j) == c) run++;
+            if (n > DUMP_LINE - 8) { // flush a very fragmented row early
+                line[n] = 0;
+                pc.printf("%s", line);
+                n = 0;
+            }
+            line[n++] = c;
+            if (run > 1) n += sprintf(line + n, "%d", run);
+            i += run;
         }
-        pc.printf("\r\n");
+        line[n] = 0;
+        pc.printf("%s\r\n", line);
     }
 }
 
@@ -174,22 +997,137 @@ MapItem* get_west(int x, int y)
  */
  MapItem* get_here(int x, int y)
  {
-    MapItem* it = (MapItem *) getItem(get_active_map()->items, XY_KEY(x, y));
-    if (it != NULL && it->type == CLEAR) { // if existing and CLEAR type then remove
-        map_erase(x, y);
-    }
-    return it; // returns item
+    return top_item(get_active_map(), x, y); // returns topmost item
  }
 
- 
+/**
+ * Returns the MapItem on one layer at current coordinate location
+ */
+MapItem* get_layer(int layer, int x, int y)
+{
+    return layer_item(get_active_map(), layer, x, y);
+}
+
+/**
+ * Fills out[] with every layer's item at (x,y), ground first
+ */
+void map_stack(int x, int y, MapItem* out[NUM_LAYERS])
+{
+    Map* map = get_active_map();
+    for (int layer = 0; layer < NUM_LAYERS; layer++) {
+        out[layer] = layer_item(map, layer, x, y);
+    }
+}
+
+/**
+ * Returns whether every layer at (x,y) lets the player through
+ */
+int map_walkable(int x, int y)
+{
+    Map* map = get_active_map();
+    if (x < 0 || y < 0 || x >= map->w || y >= map->h) return false;
+    for (int layer = 0; layer < NUM_LAYERS; layer++) {
+        MapItem* it = layer_item(map, layer, x, y);
+        if (it && it->type != CLEAR && !it->walkable) return false;
+    }
+    return true;
+}
+
+/**
+ * Returns whether (x,y) blocks line of sight
+ */
+int map_opaque(int x, int y)
+{
+    Map* map = get_active_map();
+    if (x < 0 || y < 0 || x >= map->w || y >= map->h) return true;
+    for (int layer = 0; layer < NUM_LAYERS; layer++) {
+        MapItem* it = layer_item(map, layer, x, y);
+        if (it && (it->type == WALL || it->type == DOOR)) return true;
+    }
+    return false;
+}
+
+
+/**
+ * Returns the 3x3 block of MapItems around (x,y) in one pass
+ */
+void map_neighbourhood(int x, int y, MapItem* out[9])
+{
+    Map* map = get_active_map();
+    for (int j = -1; j <= 1; j++)
+    {
+        for (int i = -1; i <= 1; i++)
+        {
+            int k = (j+1)*3 + (i+1);
+            out[k] = top_item(map, x + i, y + j); // NULL when off the map
+        }
+    }
+}
 
 /**
  * Erases item on a location by replacing it with a clear sentinel
  */
 void map_erase(int x, int y)
 {
-    MapItem* item = (MapItem*)insertItem(get_active_map()->items, XY_KEY(x, y), (void*)&CLEAR_SENTINEL);
-    if(item) free(item);
+    put_item(LAYER_OBJECT, x, y, (MapItem*) &CLEAR_SENTINEL);
+}
+
+/**
+ * Erases one layer at a location; hashed layers keep a clear sentinel
+ */
+void map_erase_layer(int layer, int x, int y)
+{
+    if (layer == LAYER_GROUND) put_ground(x, y, GROUND_NONE);
+    else put_item(layer, x, y, (MapItem*) &CLEAR_SENTINEL);
+}
+
+/**
+ * Distance used by the spatial queries: steps needed to walk between two
+ * tiles, since the player only moves in the four cardinal directions.
+ */
+static int tile_distance(int x0, int y0, int x1, int y1)
+{
+    return abs(x1 - x0) + abs(y1 - y0);
+}
+
+/**
+ * Finds the closest indexed item of a type on the active map
+ */
+int map_nearest(int type, int x, int y, int* ox, int* oy)
+{
+    int slot = index_slot(type);
+    if (slot < 0) return 0; // type is not indexed
+    TypeIndex* ti = &get_active_map()->types[slot];
+    int best = -1, best_d = 0;
+    for (int i = 0; i < ti->count; i++) {
+        int d = tile_distance(x, y, ti->pos[i].x, ti->pos[i].y);
+        if (best < 0 || d < best_d) {
+            best = i;
+            best_d = d;
+        }
+    }
+    if (best < 0) return 0; // none of this type on the map
+    *ox = ti->pos[best].x;
+    *oy = ti->pos[best].y;
+    return 1;
+}
+
+/**
+ * Collects the indexed items of a type within radius r on the active map
+ */
+int map_within(int type, int x, int y, int r, MapPos* out, int max)
+{
+    int slot = index_slot(type);
+    if (slot < 0) return 0; // type is not indexed
+    TypeIndex* ti = &get_active_map()->types[slot];
+    int n = 0;
+    for (int i = 0; i < ti->count; i++) {
+        if (tile_distance(x, y, ti->pos[i].x, ti->pos[i].y) <= r) {
+            if (n < max) out[n] = ti->pos[i];
+            n++;
+        }
+    }
+    return n;
 }
 
 
@@ -200,93 +1138,44 @@ void map_erase(int x, int y)
 
 void add_plant(int x, int y)
 {
-    MapItem* w1 = (MapItem*) malloc(sizeof(MapItem));
-    w1->type = PLANT;
-    w1->draw = draw_plant;
-    w1->walkable = true;
-    w1->data = NULL;
-    void* val = insertItem(get_active_map()->items, XY_KEY(x, y), w1);
-    if (val) free(val); // If something is already there, free it
+    put_ground(x, y, GROUND_PLANT);
 }
 
 void add_other_plant(int x, int y) {
-    MapItem* w1 = (MapItem*) malloc(sizeof(MapItem));
-    w1->type = PLANT;
-    w1->draw = draw_other_plant;
-    w1->walkable = true;
-    w1->data = NULL;
-    void* val = insertItem(get_active_map()->items, XY_KEY(x, y), w1);
-    if (val) free(val); // If something is already there, free it
+    put_ground(x, y, GROUND_OTHER_PLANT);
 }
 
 void add_npc(int x, int y)
 {
-    MapItem* w1 = (MapItem*) malloc(sizeof(MapItem));
-    w1->type = NPC;
-    w1->draw = draw_npc;
-    w1->walkable = false;
-    w1->data = NULL;
-    void* val = insertItem(get_active_map()->items, XY_KEY(x, y), w1);
-    if (val) free(val); // If something is already there, free it
-
+    put_item(LAYER_OBJECT, x, y, new_item(NPC, draw_npc, false, NULL));
 }
 
 
 void add_water(int x, int y)
 {
-    MapItem* w1 = (MapItem*) malloc(sizeof(MapItem));
-    w1->type = WATER;
-    w1->draw = draw_water;
-    w1->walkable = true;
-    w1->data = NULL;
-    void* val = insertItem(get_active_map()->items, XY_KEY(x, y), w1);
-    if (val) free(val); // If something is already there, free it
+    put_item(LAYER_OBJECT, x, y, new_item(WATER, draw_water, true, NULL));
 }
 
 void add_fire(int x, int y)
 {
-    MapItem* w1 = (MapItem*) malloc(sizeof(MapItem));
-    w1->type = FIRE; // CHECK HERE
-    w1->draw = draw_fire;
-    w1->walkable = true;
-    w1->data = NULL;
-    void* val = insertItem(get_active_map()->items, XY_KEY(x, y), w1);
-    if (val) free(val); // If something is already there, free it
+    put_item(LAYER_OBJECT, x, y, new_item(FIRE, draw_fire, true, NULL));
 }
 
 void add_earth(int x, int y)
 {
-    MapItem* w1 = (MapItem*) malloc(sizeof(MapItem));
-    w1->type = EARTH;
-    w1->draw = draw_earth;
-    w1->walkable = true;
-    w1->data = NULL;
-    void* val = insertItem(get_active_map()->items, XY_KEY(x, y), w1);
-    if (val) free(val); // If something is already there, free it
+    put_item(LAYER_OBJECT, x, y, new_item(EARTH, draw_earth, true, NULL));
 }
 
 
 void add_buzz(int x, int y)
 {
-    MapItem* w1 = (MapItem*) malloc(sizeof(MapItem));
-    w1->type = ENEMY;
-    w1->draw = draw_buzz;
-    w1->walkable = true;
-    w1->data = NULL;
-    void* val = insertItem(get_active_map()->items, XY_KEY(x, y), w1);
-    if (val) free(val); // If something is already there, free it
+    put_item(LAYER_OBJECT, x, y, new_item(ENEMY, draw_buzz, true, NULL));
 }
 
 void add_slain_buzz(int x, int y)
 {
-    MapItem* w1 = (MapItem*) malloc(sizeof(MapItem));
-    w1->type = ENEMY_SLAIN;
-    w1->draw = draw_plant; // IMPLEMENT
-    w1->walkable = true;
-    w1->data = NULL;
     //buzzStatus = 0;
-    void* val = insertItem(get_active_map()->items, XY_KEY(x, y), w1);
-    if (val) free(val); // If something is already there, free it
+    put_item(LAYER_OBJECT, x, y, new_item(ENEMY_SLAIN, draw_plant, true, NULL)); // IMPLEMENT
 }
 
 
@@ -300,14 +1189,9 @@ void add_wall(int x, int y, int dir, int len)
 {
     for(int i = 0; i < len; i++)
     {
-        MapItem* w1 = (MapItem*) malloc(sizeof(MapItem));
-        w1->type = WALL;
-        w1->draw = draw_wall;
-        w1->walkable = false;
-        w1->data = NULL;
-        unsigned key = (dir == HORIZONTAL) ? XY_KEY(x+i, y) : XY_KEY(x, y+i);
-        void* val = insertItem(get_active_map()->items, key, w1);
-        if (val) free(val); // If something is already there, free it
+        MapItem* w1 = new_item(WALL, draw_wall, false, NULL);
+        if (dir == HORIZONTAL) put_item(LAYER_OBJECT, x+i, y, w1);
+        else                   put_item(LAYER_OBJECT, x, y+i, w1);
     }
 }
 
@@ -315,59 +1199,40 @@ void add_door(int x, int y, int dir, int len)
 {
     for(int i = 0; i < len; i++)
     {
-        MapItem* w1 = (MapItem*) malloc(sizeof(MapItem));
-        w1->type = DOOR;
-        w1->draw = draw_door;
-        w1->walkable = false;
-        w1->data = NULL;
-        unsigned key = (dir == HORIZONTAL) ? XY_KEY(x+i, y) : XY_KEY(x, y+i);
-        void* val = insertItem(get_active_map()->items, key, w1);
-        if (val) free(val); // If something is already there, free it
+        MapItem* w1 = new_item(DOOR, draw_door, false, NULL);
+        if (dir == HORIZONTAL) put_item(LAYER_OBJECT, x+i, y, w1);
+        else                   put_item(LAYER_OBJECT, x, y+i, w1);
     }
 }
 
 
 void add_stairs(int x, int y, int tm, int tx, int ty)
 {
-    MapItem* w1 = (MapItem*) malloc(sizeof(MapItem));
-    w1->type = STAIRS;
-    w1->draw = draw_stairs;
-    w1->walkable = true;
     StairsData* data = (StairsData*) malloc(sizeof(StairsData));
     data->tm = tm;
     data->tx = tx;
     data->ty = ty;
-    w1->data = data;
-    void* val = insertItem(get_active_map()->items, XY_KEY(x, y), w1);
-    if (val) free(val); // If something is already there, free it    
+    put_item(LAYER_OBJECT, x, y, new_item(STAIRS, draw_stairs, true, data));
 }
 
 
 void add_cave(int x, int y, int n, int tm, int tx, int ty)
 {
-    MapItem* w1 = (MapItem*) malloc(sizeof(MapItem));
-    w1->type = CAVE;
-    if (n==1){
-        w1->draw = draw_cave1;
-    }
+    DrawFunc draw = draw_cave1;
     if (n==2){
-        w1->draw = draw_cave2;
+        draw = draw_cave2;
     }
     if (n==3){
-        w1->draw = draw_cave3;
+        draw = draw_cave3;
     }
     if (n==4){
-        w1->draw = draw_cave4;
+        draw = draw_cave4;
     }
-    w1->walkable = true;
     StairsData* data = (StairsData*) malloc(sizeof(StairsData));
     data->tm = tm;
     data->tx = tx;
     data->ty = ty;
-    w1->data = data;
-    
-    void* val = insertItem(get_active_map()->items, XY_KEY(x, y), w1);
-    if (val) free(val); // If something is already there, free it    
+    put_item(LAYER_OBJECT, x, y, new_item(CAVE, draw, true, data));
 }
 
 
@@ -375,13 +1240,7 @@ void add_mud(int x, int y, int dir, int len)
 {
     for(int i = 0; i < len; i++)
     {
-        MapItem* w1 = (MapItem*) malloc(sizeof(MapItem));
-        w1->type = MUD;
-        w1->draw = draw_mud;
-        w1->walkable = true;
-        w1->data = NULL;
-        unsigned key = (dir == HORIZONTAL) ? XY_KEY(x+i, y) : XY_KEY(x, y+i);
-        void* val = insertItem(get_active_map()->items, key, w1);
-        if (val) free(val); // If something is already there, free it
-    }
-}
\ No newline at end of file
+        if (dir == HORIZONTAL) put_ground(x+i, y, GROUND_MUD);
+        else                   put_ground(x, y+i, GROUND_MUD);
+    }
+}
@@ -66,6 +66,23 @@ typedef struct {
     
 } CaveData;
 
+/**
+ * A tile position, as returned by the spatial queries.
+ */
+typedef struct {
+    short x, y;
+} MapPos;
+
+// Map layers, drawn bottom (ground) to top (overlay). Each coordinate holds
+// at most one MapItem per layer.
+//  - Ground is terrain that is laid down when the level is built: plants, mud.
+//  - Object holds everything else added by the add_* functions.
+//  - Overlay sits above objects and is free for effects and markers.
+#define LAYER_GROUND  0
+#define LAYER_OBJECT  1
+#define LAYER_OVERLAY 2
+#define NUM_LAYERS    3
+
 // MapItem types
 // Define more of these!
 #define WALL        0
@@ -83,14 +100,131 @@ typedef struct {
 #define EARTH       12
 #define ENEMY       13
 #define ENEMY_SLAIN 14
+#define NUM_TYPES   15  // One past the last type, for tables by type
+
+/**
+ * A function that populates the active map with items using the add_*
+ * functions. Each map has one; it runs the first time the map is activated
+ * and again whenever an unchanged map is reloaded after eviction, so it must
+ * build the same map every time.
+ */
+typedef void (*MapBuilder)();
+
+// Most maps the registry can hold
+#define MAX_MAPS 8
+
+// Default RAM budget, in bytes, shared by all resident maps
+#define MAP_RAM_BUDGET (12*1024)
 
 /**
- * Initializes the internal structures for all maps. This does not populate
- * the map with items, but allocates space for them, initializes the hash tables, 
- * and sets the width and height.
+ * Resets the map registry. Maps are then added with map_register; nothing is
+ * allocated until a map is first activated.
  */
 void maps_init();
 
+/**
+ * Adds a map of size w x h to the registry and returns its index, or -1 if
+ * the registry is full. build populates it the first time set_active_map()
+ * selects it.
+ */
+int map_register(int w, int h, MapBuilder build);
+
+/**
+ * Sets the RAM budget for resident maps. Whenever the maps use more than
+ * this, the least recently used inactive maps are evicted. Evicted maps that
+ * changed since they were built are kept as a compact snapshot; unchanged
+ * ones are rebuilt. Either way they come back transparently when activated.
+ */
+void map_set_budget(int bytes);
+
+/**
+ * Returns the estimated RAM used by map m: its layers and index if resident,
+ * or its snapshot if evicted.
+ */
+int map_bytes(int m);
+
+/**
+ * Where the RAM of one map goes, in estimated bytes including the heap's
+ * per-allocation overhead, plus the object counts behind it.
+ */
+struct MapMemory {
+    int ground;      // Ground layer, one byte per tile
+    int tables;      // Hash table headers and bucket arrays
+    int entries;     // Hash entries
+    int items;       // MapItems
+    int data;        // StairsData owned by items
+    int index;       // Spatial index arrays
+    int snapshot;    // Snapshot, while evicted
+    int total;       // Sum of the above, same as map_bytes
+    int nentries;    // Hash entries
+    int nitems;      // MapItems, of which...
+    int types[NUM_TYPES]; // ...this many of each type
+    int ndata;       // StairsData blocks
+};
+
+/**
+ * Fills out with the RAM breakdown of map m.
+ */
+void map_memory(int m, MapMemory* out);
+
+/**
+ * Estimates the RAM a w x h map with nitems hashed items would take once
+ * resident, to check whether it fits before registering or activating it.
+ */
+int map_estimate(int w, int h, int nitems);
+
+/**
+ * Returns the number of registered maps.
+ */
+int map_count();
+
+/**
+ * Returns nonzero if map m is currently in RAM.
+ */
+int map_resident(int m);
+
+/**
+ * A function called after a tile of map m at (x,y) changed, on any layer.
+ */
+typedef void (*MapChangeFunc)(int m, int x, int y);
+
+// Most change listeners that can be registered
+#define MAX_MAP_LISTENERS 4
+
+/**
+ * Registers f to be told about every change the add_* functions and
+ * map_erase make to a map once it is built. Building or reloading a map does
+ * not count as a change. Returns 0 if there is no room for another listener.
+ */
+int map_on_change(MapChangeFunc f);
+
+/**
+ * Encodes how map m differs from a fresh run of its builder as tile records:
+ * one per hashed-layer item added, replaced or erased and one per changed
+ * ground tile. The builder runs once, into a scratch map. Returns the records
+ * in a malloc'd buffer the caller frees and their size in *size; returns
+ * NULL with *size 0 if the map is unchanged, or -1 if it cannot be
+ * serialized or there is no RAM for the buffer. The active map stays the
+ * same and no map is loaded or evicted: an evicted map is read from a copy
+ * of its snapshot in scratch RAM.
+ */
+unsigned char* map_diff(int m, int* size);
+
+/**
+ * Returns nonzero if a diff from map_diff is well formed for map m: every
+ * record is whole, names a real layer, type and ground tile, lies on map m,
+ * carries stairs data only for an item, and leads stairs or caves onto a
+ * tile of a registered map. Changes nothing.
+ */
+int map_check_diff(int m, const unsigned char* in, int len);
+
+/**
+ * Rebuilds map m from its builder and applies a diff from map_diff to it.
+ * Leaves map m active. Returns 0, with nothing changed, if the diff fails
+ * map_check_diff, or with the map only part patched if RAM runs out.
+ */
+int map_apply_diff(int m, const unsigned char* in, int len);
+
 /**
  * Returns a pointer to the active map.
  */
@@ -98,21 +232,33 @@ Map* get_active_map();
 
 /**
  * Sets the active map to map m, where m is the index of the map to activate.
+ * The map is built or reloaded first if it is not in RAM, and other maps may
+ * be evicted to stay within the RAM budget. m must be a registered map.
  * Returns a pointer to the new active map.
  */
 Map* set_active_map(int m);
 
 /**
  * Returns the map m, regardless of whether it is the active map. This function
- * does not change the active map.
+ * does not change the active map or load the map.
  */
 Map* get_map(int m);
 
 /**
- * Print the active map to the serial console.
+ * Print the active map to the serial console, see map_dump.
  */
 void print_map();
 
+/**
+ * Prints rows y..y+h-1, columns x..x+w-1 of the active map to the serial
+ * console, clipped to the map. Each row goes out as one write: its number,
+ * then runs of the topmost item's letter followed by the run length if it is
+ * more than 1, e.g. "  0 W50". Letters: W wall, D door, P plant, A water,
+ * K key, C chest, N npc, S stairs, V cave, M mud, F fire, E earth, B enemy,
+ * X slain enemy, . nothing.
+ */
+void map_dump(int x, int y, int w, int h);
+
 // Access
 /**
  * Returns the width of the active map.
@@ -150,19 +296,90 @@ MapItem* get_east(int x, int y);
 MapItem* get_west(int x, int y);
 
 /**
- * Returns the MapItem at the given location.
+ * Returns the MapItem at the given location. This is the topmost item over
+ * all layers, ignoring erased cells, or NULL if there is nothing there.
  */
 MapItem* get_here(int x, int y);
 
+/**
+ * Returns the MapItem on the given layer at the given location, or NULL if
+ * that layer is empty there. Erased cells on the object and overlay layers
+ * return an item of type CLEAR.
+ */
+MapItem* get_layer(int layer, int x, int y);
+
+/**
+ * Fills out[] with the item on every layer at (x,y), indexed by LAYER_*.
+ * Used by draw_game to composite a tile.
+ */
+void map_stack(int x, int y, MapItem* out[NUM_LAYERS]);
+
+/**
+ * Returns nonzero if the player can move onto (x,y): the location is on the
+ * map and no item on any layer blocks motion.
+ */
+int map_walkable(int x, int y);
+
+/**
+ * Returns nonzero if (x,y) blocks line of sight: it is off the map or holds
+ * a wall or door on any layer.
+ */
+int map_opaque(int x, int y);
+
+// Slots of the 3x3 block filled by map_neighbourhood, row-major around (x,y)
+#define NB_NW   0
+#define NB_N    1
+#define NB_NE   2
+#define NB_W    3
+#define NB_HERE 4
+#define NB_E    5
+#define NB_SW   6
+#define NB_S    7
+#define NB_SE   8
+
+/**
+ * Fills out[] with the 3x3 block of MapItems centered on (x,y), using the
+ * NB_* slots above. Each cell holds its topmost item, as get_here returns
+ * it; cells that are empty or outside the map are NULL. That is nine
+ * lookups, each through up to three layers, gathered once so interaction
+ * checks can work on the local array.
+ */
+void map_neighbourhood(int x, int y, MapItem* out[9]);
+
 // Directions, for using the modification functions
 #define HORIZONTAL  0
 #define VERTICAL    1
 
 /**
- * If there is a MapItem at (x,y), remove it from the map.
+ * If there is a MapItem at (x,y) on the object layer, remove it from the map.
+ * The ground underneath is left in place.
  */
 void map_erase(int x, int y);
 
+/**
+ * Remove whatever is on the given layer at (x,y).
+ */
+void map_erase_layer(int layer, int x, int y);
+
+// Spatial queries
+// The active map keeps an index of its interactive items (NPC, DOOR, STAIRS,
+// CAVE, WATER and ENEMY) that the add_* functions and map_erase keep current.
+// Distances are in walking steps: |dx| + |dy|.
+
+/**
+ * Finds the item of the given type closest to (x,y) on the active map and
+ * stores its position in (*ox, *oy). Returns 1 if one was found, 0 if there
+ * is none or the type is not indexed.
+ */
+int map_nearest(int type, int x, int y, int* ox, int* oy);
+
+/**
+ * Finds the items of the given type at most r steps from (x,y) on the active
+ * map. Up to max positions are written to out. Returns the number of items
+ * in range, which can be larger than max.
+ */
+int map_within(int type, int x, int y, int r, MapPos* out, int max);
+
 /**
  * Add WALL items in a line of length len beginning at (x,y).
  * If dir == HORIZONTAL, the line is in the direction of increasing x.
@@ -174,8 +391,9 @@ void map_erase(int x, int y);
 void add_wall(int x, int y, int dir, int len);
 
 /**
- * Add a PLANT item at (x,y). If there is already a MapItem at (x,y), erase it
- * before adding the plant.
+ * Add a PLANT item at (x,y) on the ground layer. Plants and mud replace the
+ * ground at (x,y) but leave any object standing there alone; every other
+ * add_* function places an object and replaces the object at (x,y).
  */
 void add_plant(int x, int y);
 void add_other_plant(int x, int y);
@@ -0,0 +1,121 @@
+//=================================================================
+// The memory accounting class file.
+//
+// Copyright 2023 Georgia Tech. All rights reserved.
+// The materials provided by the instructor in this course are for
+// the use of the students currently enrolled in the course.
+// Copyrighted course materials may not be further disseminated.
+// This file must NOT be made publicly available anywhere.
+//==================================================================
+
+#include "memory.h"
+#include "globals.h"
+#include "map.h"
+
+// Most free blocks mem_total_free collects before giving up
+#define MEM_PROBE_BLOCKS 16
+
+// Names of the item types, for the report
+static const char* TYPE_NAMES[NUM_TYPES] = {
+    "wall", "door", "plant", "water", "key", "chest", "npc", "clear",
+    "stairs", "cave", "mud", "fire", "earth", "enemy", "enemy_slain"
+};
+
+static int peak_map_bytes;      // Most map bytes seen by mem_sample
+static int low_free = -1;       // Smallest largest-free block seen, -1 if none
+
+///////////////////////
+// Heap probing
+///////////////////////
+
+int mem_largest_free()
+{
+    int lo = 0, hi = MEM_PROBE_MAX;
+    while (lo < hi) { // binary search for the largest size malloc accepts
+        int mid = (lo + hi + 1) / 2;
+        void* p = malloc(mid);
+        if (p) {
+            free(p);
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    return lo;
+}
+
+int mem_total_free()
+{
+    void* blocks[MEM_PROBE_BLOCKS];
+    int n = 0, total = 0;
+    while (n < MEM_PROBE_BLOCKS) { // take the largest block until none is left
+        int size = mem_largest_free();
+        if (size < 16) break;
+        blocks[n] = malloc(size);
+        if (blocks[n] == NULL) break;
+        total += size;
+        n++;
+    }
+    while (n > 0) free(blocks[--n]);
+    return total;
+}
+
+///////////////////////
+// Accounting
+///////////////////////
+
+int mem_map_bytes()
+{
+    int total = 0;
+    for (int m = 0; m < map_count(); m++) total += map_bytes(m);
+    return total;
+}
+
+void mem_sample()
+{
+    int bytes = mem_map_bytes();
+    if (bytes > peak_map_bytes) peak_map_bytes = bytes;
+    int largest = mem_largest_free();
+    if (low_free < 0 || largest < low_free) low_free = largest;
+}
+
+int mem_peak()
+{
+    return peak_map_bytes;
+}
+
+int mem_low_free()
+{
+    return low_free;
+}
+
+int mem_fits(int bytes)
+{
+    return mem_largest_free() >= bytes + MEM_RESERVE;
+}
+
+void mem_report()
+{
+    MapMemory mem;
+    int types[NUM_TYPES];
+    memset(types, 0, sizeof(types));
+
+    pc.printf("map state  total ground tables entries items data index snap\r\n");
+    for (int m = 0; m < map_count(); m++) {
+        map_memory(m, &mem);
+        const char* state = map_resident(m) ? "in " : mem.snapshot ? "snap" : "-  ";
+        pc.printf("%3d %-4s %6d %6d %6d %7d %5d %4d %5d %4d\r\n", m, state,
+                  mem.total, mem.ground, mem.tables, mem.entries, mem.items,
+                  mem.data, mem.index, mem.snapshot);
+        for (int t = 0; t < NUM_TYPES; t++) types[t] += mem.types[t];
+    }
+
+    pc.printf("items by type (resident maps):\r\n");
+    for (int t = 0; t < NUM_TYPES; t++) {
+        if (types[t]) pc.printf("  %-12s %5d\r\n", TYPE_NAMES[t], types[t]);
+    }
+
+    pc.printf("maps     %6d bytes heap, peak %d\r\n", mem_map_bytes(), mem_peak());
+    pc.printf("heap free %d (largest %d, lowest seen %d)\r\n",
+              mem_total_free(), mem_largest_free(), mem_low_free());
+}
@@ -0,0 +1,74 @@
+//=================================================================
+// The memory accounting header file.
+//
+// Copyright 2023 Georgia Tech. All rights reserved.
+// The materials provided by the instructor in this course are for
+// the use of the students currently enrolled in the course.
+// Copyrighted course materials may not be further disseminated.
+// This file must NOT be made publicly available anywhere.
+//==================================================================
+
+#ifndef MEMORY_H
+#define MEMORY_H
+
+/*
+RAM accounting for the game. The maps report what their layers hold (see
+map_memory) and other subsystems report their static pools; the heap itself
+is measured by probing it with malloc, since the C library does not say how
+much is left. Probing takes a few dozen malloc/free pairs, so it is done in
+mem_sample() every MEM_SAMPLE_FRAMES game frames, not on every query.
+*/
+
+// Game frames between calls to mem_sample from the game loop
+#define MEM_SAMPLE_FRAMES 10
+
+// Largest block the heap probe tries to allocate
+#define MEM_PROBE_MAX (32*1024)
+
+// Heap kept free for speech bubbles, saves and other short-lived blocks
+#define MEM_RESERVE 1024
+
+/**
+ * Measures the heap and updates the high-water marks.
+ */
+void mem_sample();
+
+/**
+ * Returns the largest block that can be malloc'd right now.
+ */
+int mem_largest_free();
+
+/**
+ * Returns the total free heap, summed over free blocks (fragments smaller than
+ * a few bytes are missed).
+ */
+int mem_total_free();
+
+/**
+ * Returns the bytes all registered maps use, resident or as snapshots.
+ */
+int mem_map_bytes();
+
+/**
+ * Returns the most map bytes seen by mem_sample.
+ */
+int mem_peak();
+
+/**
+ * Returns the smallest largest-free block seen by mem_sample.
+ */
+int mem_low_free();
+
+/**
+ * Returns nonzero if bytes more can be allocated while still leaving
+ * MEM_RESERVE free, e.g. mem_fits(map_estimate(w, h, n)) before a new map.
+ */
+int mem_fits(int bytes);
+
+/**
+ * Prints the memory use per map, per item type and per subsystem, and the
+ * state of the heap, over pc.
+ */
+void mem_report();
+
+#endif // MEMORY_H
@@ -0,0 +1,354 @@
+//=================================================================
+// The pathfinding class file.
+//
+// Copyright 2023 Georgia Tech. All rights reserved.
+// The materials provided by the instructor in this course are for
+// the use of the students currently enrolled in the course.
+// Copyrighted course materials may not be further disseminated.
+// This file must NOT be made publicly available anywhere.
+//==================================================================
+
+#include "pathfind.h"
+#include "globals.h"
+
+/**
+ * A search node: one tile the current search has reached.
+ */
+struct PfNode {
+    short x, y;         // Tile position
+    unsigned short g;   // Steps from the start
+    unsigned short f;   // g plus the heuristic distance to the target
+    short parent;       // Node this one was reached from, -1 for the start
+    unsigned char closed; // Nonzero once expanded
+};
+
+/**
+ * A path slot: one requested search and, once found, its cached result.
+ */
+struct PfPath {
+    int state;              // PF_* state
+    int map;                // Map index the search runs on
+    short sx, sy, tx, ty;   // Start and target tiles
+    short x0, y0, x1, y1;   // Box around every tile the search looked at
+    int len;                // Steps in the found path
+    MapPos steps[PF_MAX_LEN]; // Tiles after the start, ending on the target
+};
+
+///////////////////////
+// Static pool
+///////////////////////
+
+// Open-addressing table from tile to node; must be a power of two
+#define PF_HASH_SIZE (2*PF_MAX_NODES)
+
+// Open set heap. Nodes whose cost improves are pushed again and the stale
+// copy is skipped when popped, so it can hold more entries than nodes.
+#define PF_HEAP_SIZE (2*PF_MAX_NODES)
+
+static PfNode nodes[PF_MAX_NODES];      // Node pool for the current search
+static int num_nodes;                   // Nodes in use
+static short node_hash[PF_HASH_SIZE];   // Tile -> node index, -1 if none
+static short open_heap[PF_HEAP_SIZE];   // Min-heap of node indices by f
+static int open_count;                  // Entries in open_heap
+
+static PfPath paths[PF_MAX_PATHS];      // Path slots
+static int current = -1;                // Slot being searched, or -1
+
+///////////////////////
+// Helpers
+///////////////////////
+
+/**
+ * Heuristic: steps between two tiles when moving in four directions.
+ */
+static int pf_distance(int x0, int y0, int x1, int y1)
+{
+    return abs(x1 - x0) + abs(y1 - y0);
+}
+
+/**
+ * Returns the node_hash slot for a tile: either the slot holding its node or
+ * the empty slot where it would go.
+ */
+static int hash_slot(int x, int y)
+{
+    int h = (x * 31 + y) & (PF_HASH_SIZE - 1);
+    while (node_hash[h] >= 0) {
+        PfNode* n = &nodes[node_hash[h]];
+        if (n->x == x && n->y == y) break;
+        h = (h + 1) & (PF_HASH_SIZE - 1); // linear probing
+    }
+    return h;
+}
+
+/**
+ * Pushes node n onto the open heap. Returns false if the heap is full.
+ */
+static int heap_push(int n)
+{
+    if (open_count == PF_HEAP_SIZE) return false;
+    int i = open_count++;
+    while (i > 0) { // sift up
+        int p = (i - 1) / 2;
+        if (nodes[open_heap[p]].f <= nodes[n].f) break;
+        open_heap[i] = open_heap[p];
+        i = p;
+    }
+    open_heap[i] = n;
+    return true;
+}
+
+/**
+ * Pops the node with the smallest f from the open heap.
+ */
+static int heap_pop()
+{
+    int top = open_heap[0];
+    int last = open_heap[--open_count];
+    int i = 0;
+    while (1) { // sift down
+        int c = 2 * i + 1;
+        if (c >= open_count) break;
+        if (c + 1 < open_count && nodes[open_heap[c+1]].f < nodes[open_heap[c]].f) c++;
+        if (nodes[last].f <= nodes[open_heap[c]].f) break;
+        open_heap[i] = open_heap[c];
+        i = c;
+    }
+    if (open_count > 0) open_heap[i] = last;
+    return top;
+}
+
+/**
+ * Resets the pool and seeds it with the start of path slot p.
+ */
+static void start_search(int p)
+{
+    PfPath* path = &paths[p];
+    memset(node_hash, 0xFF, sizeof(node_hash)); // all -1
+    num_nodes = 0;
+    open_count = 0;
+
+    PfNode* n = &nodes[num_nodes];
+    n->x = path->sx;
+    n->y = path->sy;
+    n->g = 0;
+    n->f = pf_distance(path->sx, path->sy, path->tx, path->ty);
+    n->parent = -1;
+    n->closed = false;
+    node_hash[hash_slot(n->x, n->y)] = num_nodes;
+    heap_push(num_nodes++);
+    path->x0 = path->x1 = path->sx;
+    path->y0 = path->y1 = path->sy;
+
+    path->state = PF_SEARCHING;
+    current = p;
+}
+
+/**
+ * Ends the current search with the given state.
+ */
+static void finish_search(int state)
+{
+    paths[current].state = state;
+    current = -1;
+}
+
+/**
+ * Copies the chain of parents ending at node n into the current slot.
+ */
+static void store_path(int n)
+{
+    PfPath* path = &paths[current];
+    int len = nodes[n].g;
+    if (len > PF_MAX_LEN) {
+        finish_search(PF_FAILED); // too long to cache
+        return;
+    }
+    path->len = len;
+    for (int i = len - 1; i >= 0; i--) {
+        path->steps[i].x = nodes[n].x;
+        path->steps[i].y = nodes[n].y;
+        n = nodes[n].parent;
+    }
+    finish_search(PF_DONE);
+}
+
+/**
+ * Picks the next queued slot on the active map and starts it. Returns false
+ * if there is nothing to search.
+ */
+static int next_search()
+{
+    int m = get_active_map_index();
+    for (int p = 0; p < PF_MAX_PATHS; p++) {
+        if (paths[p].state == PF_QUEUED && paths[p].map == m) {
+            start_search(p);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Map change listener: forgets searches and paths the change may affect.
+ */
+static void pf_map_changed(int m, int x, int y)
+{
+    for (int p = 0; p < PF_MAX_PATHS; p++) {
+        PfPath* path = &paths[p];
+        if (path->map != m) continue;
+        if (path->state == PF_SEARCHING) { // restart from scratch
+            path->state = PF_QUEUED;
+            current = -1;
+        } else if (path->state == PF_FAILED) { // only if the search saw (x,y)
+            if (x >= path->x0 && x <= path->x1 && y >= path->y0 && y <= path->y1)
+                path->state = PF_QUEUED;
+        } else if (path->state == PF_DONE) { // only if it goes through (x,y)
+            for (int i = 0; i < path->len; i++) {
+                if (path->steps[i].x == x && path->steps[i].y == y) {
+                    path->state = PF_QUEUED;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+///////////////////////
+// Public functions
+///////////////////////
+
+void pf_init()
+{
+    memset(paths, 0, sizeof(paths)); // all PF_FREE
+    current = -1;
+    map_on_change(pf_map_changed);
+}
+
+int pf_request(int sx, int sy, int tx, int ty)
+{
+    for (int p = 0; p < PF_MAX_PATHS; p++) {
+        if (paths[p].state == PF_FREE) {
+            paths[p].state = PF_QUEUED;
+            paths[p].map = get_active_map_index();
+            paths[p].sx = sx;
+            paths[p].sy = sy;
+            paths[p].tx = tx;
+            paths[p].ty = ty;
+            paths[p].len = 0;
+            return p;
+        }
+    }
+    return -1; // every slot is in use
+}
+
+int pf_step(int budget)
+{
+    int expanded = 0;
+    static const int DX[4] = {0, 0, 1, -1};
+    static const int DY[4] = {-1, 1, 0, 0};
+
+    while (expanded < budget)
+    {
+        if (current >= 0 && paths[current].map != get_active_map_index()) {
+            paths[current].state = PF_QUEUED; // map was left, resume later
+            current = -1;
+        }
+        if (current < 0 && !next_search()) break; // nothing to do
+
+        PfPath* path = &paths[current];
+        if (open_count == 0) {
+            finish_search(PF_FAILED); // target unreachable
+            continue;
+        }
+        int n = heap_pop();
+        if (nodes[n].closed) continue; // stale heap copy
+        nodes[n].closed = true;
+        expanded++;
+
+        if (nodes[n].x == path->tx && nodes[n].y == path->ty) {
+            store_path(n);
+            continue;
+        }
+
+        bool exhausted = false;
+        for (int d = 0; d < 4 && !exhausted; d++)
+        {
+            int x = nodes[n].x + DX[d];
+            int y = nodes[n].y + DY[d];
+            // Blocked tiles count too: opening one may open a way
+            if (x < path->x0) path->x0 = x;
+            if (x > path->x1) path->x1 = x;
+            if (y < path->y0) path->y0 = y;
+            if (y > path->y1) path->y1 = y;
+            if (!map_walkable(x, y)) continue;
+
+            int slot = hash_slot(x, y);
+            int c = node_hash[slot];
+            unsigned short g = nodes[n].g + 1;
+            if (c < 0) { // first time this tile is reached
+                if (num_nodes == PF_MAX_NODES) { // pool is exhausted
+                    exhausted = true;
+                    break;
+                }
+                c = num_nodes++;
+                node_hash[slot] = c;
+                nodes[c].x = x;
+                nodes[c].y = y;
+                nodes[c].closed = false;
+            } else if (nodes[c].closed || nodes[c].g <= g) {
+                continue; // no improvement
+            }
+            nodes[c].g = g;
+            nodes[c].f = g + pf_distance(x, y, path->tx, path->ty);
+            nodes[c].parent = n;
+            if (!heap_push(c)) exhausted = true;
+        }
+        if (exhausted) {
+            finish_search(PF_FAILED); // search outgrew the static pool
+        }
+    }
+    return expanded;
+}
+
+int pf_status(int h)
+{
+    return paths[h].state;
+}
+
+int pf_path(int h, MapPos* out, int max)
+{
+    PfPath* path = &paths[h];
+    if (path->state != PF_DONE) return -1;
+    for (int i = 0; i < path->len && i < max; i++) {
+        out[i] = path->steps[i];
+    }
+    return path->len;
+}
+
+int pf_next(int h, int x, int y, int* nx, int* ny)
+{
+    PfPath* path = &paths[h];
+    if (path->state != PF_DONE || path->len == 0) return false;
+    int i = -1; // position of (x,y) on the path, -1 for the start
+    if (x != path->sx || y != path->sy) {
+        for (i = 0; i < path->len; i++) {
+            if (path->steps[i].x == x && path->steps[i].y == y) break;
+        }
+        if (i >= path->len - 1) return false; // not on it, or at the end
+    }
+    *nx = path->steps[i+1].x;
+    *ny = path->steps[i+1].y;
+    return true;
+}
+
+void pf_release(int h)
+{
+    if (current == h) current = -1;
+    paths[h].state = PF_FREE;
+}
+
+int pf_bytes()
+{
+    return sizeof(nodes) + sizeof(node_hash) + sizeof(open_heap) + sizeof(paths);
+}
@@ -0,0 +1,100 @@
+//=================================================================
+// The pathfinding header file.
+//
+// Copyright 2023 Georgia Tech. All rights reserved.
+// The materials provided by the instructor in this course are for
+// the use of the students currently enrolled in the course.
+// Copyrighted course materials may not be further disseminated.
+// This file must NOT be made publicly available anywhere.
+//==================================================================
+
+#ifndef PATHFIND_H
+#define PATHFIND_H
+
+#include "map.h"
+
+/*
+A* search over the walkability of a map (see map_walkable), in the four
+cardinal directions. Searches are time-sliced so they never stall the game
+loop: pf_request() only queues a search, and pf_step() is called once per
+frame to expand at most a fixed number of nodes. All working memory is a
+static pool, so a search that needs more than PF_MAX_NODES nodes fails
+instead of allocating.
+
+Finished paths are cached in their slot until released. If the add_*
+functions or map_erase change a tile that a cached path goes through, the
+path is thrown away and searched again. A failed search is only retried
+when a tile changes inside the box of tiles it looked at.
+
+Nothing in the game requests paths yet, so the game loop does not run the
+pathfinder. A caller adds pf_init() after maps_init() and
+pf_step(PF_FRAME_BUDGET) to each frame.
+*/
+
+// Node pool size: the most tiles one search may visit
+#define PF_MAX_NODES    256
+
+// Most steps in a stored path
+#define PF_MAX_LEN      64
+
+// Most paths (queued, searching or cached) at once
+#define PF_MAX_PATHS    4
+
+// Node expansions per frame that the game loop allows
+#define PF_FRAME_BUDGET 32
+
+// Path slot states, as returned by pf_status
+#define PF_FREE     0   // Slot unused
+#define PF_QUEUED   1   // Waiting for pf_step to start the search
+#define PF_SEARCHING 2  // Search in progress
+#define PF_DONE     3   // Path found and cached
+#define PF_FAILED   4   // No path, or it needed too many nodes or steps
+
+/**
+ * Initializes the pathfinder and hooks it up to map changes. Call once after
+ * maps_init().
+ */
+void pf_init();
+
+/**
+ * Queues a search from (sx,sy) to (tx,ty) on the active map. Returns a path
+ * handle, or -1 if all PF_MAX_PATHS slots are in use.
+ */
+int pf_request(int sx, int sy, int tx, int ty);
+
+/**
+ * Does up to budget node expansions of pending searches. Only searches on
+ * the active map make progress. Returns the number of nodes expanded.
+ */
+int pf_step(int budget);
+
+/**
+ * Returns the state of path h: one of the PF_* states above.
+ */
+int pf_status(int h);
+
+/**
+ * Copies up to max positions of the finished path h into out, from the tile
+ * after the start to the target. Returns the path length in steps, or -1 if
+ * the path is not PF_DONE.
+ */
+int pf_path(int h, MapPos* out, int max);
+
+/**
+ * Finds (x,y) on the finished path h and stores the tile after it in
+ * (*nx, *ny). Returns 1 on success, or 0 if the path is not ready or (x,y)
+ * is not on it (or is its end).
+ */
+int pf_next(int h, int x, int y, int* nx, int* ny);
+
+/**
+ * Frees path slot h.
+ */
+void pf_release(int h);
+
+/**
+ * Returns the bytes of static RAM the pathfinder's pools take.
+ */
+int pf_bytes();
+
+#endif // PATHFIND_H
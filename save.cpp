@@ -0,0 +1,182 @@
+//=================================================================
+// The save game class file.
+//
+// Copyright 2023 Georgia Tech. All rights reserved.
+// The materials provided by the instructor in this course are for
+// the use of the students currently enrolled in the course.
+// Copyrighted course materials may not be further disseminated.
+// This file must NOT be made publicly available anywhere.
+//==================================================================
+
+#include "save.h"
+#include "globals.h"
+#include "map.h"
+
+#define SAVE_MAGIC "SLB1"
+#define SAVE_MAGIC_BYTES 4
+
+// Largest save load_game will read
+#define SAVE_MAX_BYTES (16*1024)
+
+///////////////////////
+// Helpers
+///////////////////////
+
+static unsigned char* put_u16(unsigned char* p, unsigned v)
+{
+    p[0] = (v >> 8) & 0xFF;
+    p[1] = v & 0xFF;
+    return p + 2;
+}
+
+static unsigned char* put_u32(unsigned char* p, unsigned v)
+{
+    p = put_u16(p, v >> 16);
+    return put_u16(p, v & 0xFFFF);
+}
+
+static unsigned get_u16(const unsigned char* p)
+{
+    return (p[0] << 8) | p[1];
+}
+
+static unsigned get_u32(const unsigned char* p)
+{
+    return (get_u16(p) << 16) | get_u16(p + 2);
+}
+
+/**
+ * Returns the 16-bit sum of len bytes.
+ */
+static unsigned checksum(const unsigned char* p, int len)
+{
+    unsigned sum = 0;
+    for (int i = 0; i < len; i++) sum += p[i];
+    return sum & 0xFFFF;
+}
+
+/**
+ * Walks the map section of a save without changing anything. Returns false
+ * if it does not fit in len bytes, names a map that is not registered or
+ * holds a diff that map_check_diff rejects.
+ */
+static int check_maps(const unsigned char* p, int len)
+{
+    const unsigned char* end = p + len;
+    if (p + 2 > end) return false;
+    if (p[0] >= map_count()) return false; // active map
+    int count = p[1];
+    p += 2;
+    for (int i = 0; i < count; i++) {
+        if (p + 5 > end || p[0] >= map_count()) return false;
+        unsigned size = get_u32(p + 1);
+        if (size > (unsigned)(end - p - 5)) return false;
+        if (!map_check_diff(p[0], p + 5, size)) return false;
+        p += 5 + size;
+    }
+    return p == end;
+}
+
+///////////////////////
+// Public functions
+///////////////////////
+
+unsigned char* save_encode(const void* player, int size, int* len)
+{
+    // Diff each map once, as every diff rebuilds the map in scratch RAM
+    unsigned char* diffs[MAX_MAPS];
+    int sizes[MAX_MAPS];
+    int bytes = SAVE_MAGIC_BYTES + 2 + size + 2 + 2;
+    int changed = 0;
+    int ok = true;
+    for (int m = 0; m < map_count(); m++) {
+        diffs[m] = NULL;
+        if (!ok) continue;
+        diffs[m] = map_diff(m, &sizes[m]);
+        if (sizes[m] < 0) ok = false;
+        if (diffs[m] == NULL) continue; // as built, nothing to store
+        bytes += 5 + sizes[m];
+        changed++;
+    }
+    unsigned char* out = ok ? (unsigned char*) malloc(bytes) : NULL;
+
+    if (out) {
+        unsigned char* p = out;
+        memcpy(p, SAVE_MAGIC, SAVE_MAGIC_BYTES);
+        p += SAVE_MAGIC_BYTES;
+        p = put_u16(p, size);
+        memcpy(p, player, size);
+        p += size;
+        *p++ = get_active_map_index();
+        *p++ = changed;
+        for (int m = 0; m < map_count(); m++) {
+            if (diffs[m] == NULL) continue;
+            *p = m;
+            put_u32(p + 1, sizes[m]);
+            memcpy(p + 5, diffs[m], sizes[m]);
+            p += 5 + sizes[m];
+        }
+        put_u16(p, checksum(out, p - out));
+        *len = bytes;
+    }
+    for (int m = 0; m < map_count(); m++) free(diffs[m]);
+    return out;
+}
+
+int save_decode(const unsigned char* in, int len, void* player, int size)
+{
+    // Validate everything before touching the game
+    int head = SAVE_MAGIC_BYTES + 2;
+    if (len < head + 2 || memcmp(in, SAVE_MAGIC, SAVE_MAGIC_BYTES)) return false;
+    if (checksum(in, len - 2) != get_u16(in + len - 2)) return false;
+    if ((int) get_u16(in + SAVE_MAGIC_BYTES) != size || head + size > len - 2) return false;
+    const unsigned char* p = in + head + size;
+    const unsigned char* end = in + len - 2;
+    if (!check_maps(p, end - p)) return false;
+
+    int active = p[0];
+    int count = p[1];
+    p += 2;
+    for (int i = 0; i < count; i++) {
+        int m = p[0];
+        int diff = get_u32(p + 1);
+        if (!map_apply_diff(m, p + 5, diff)) return false; // out of RAM
+        p += 5 + diff;
+    }
+    memcpy(player, in + head, size);
+    set_active_map(active);
+    return true;
+}
+
+int save_game(const void* player, int size)
+{
+    int bytes;
+    unsigned char* buf = save_encode(player, size, &bytes);
+    if (buf == NULL) return -1;
+
+    FILE* f = fopen(SAVE_PATH, "wb");
+    int written = -1;
+    if (f) {
+        if ((int) fwrite(buf, 1, bytes, f) == bytes) written = bytes;
+        fclose(f);
+    }
+    free(buf);
+    return written;
+}
+
+int delete_save()
+{
+    return remove(SAVE_PATH) == 0;
+}
+
+int load_game(void* player, int size)
+{
+    FILE* f = fopen(SAVE_PATH, "rb");
+    if (f == NULL) return false; // no save yet
+    unsigned char* buf = (unsigned char*) malloc(SAVE_MAX_BYTES);
+    int len = buf ? fread(buf, 1, SAVE_MAX_BYTES, f) : 0;
+    fclose(f);
+    int ok = len > 0 && len < SAVE_MAX_BYTES && save_decode(buf, len, player, size);
+    free(buf);
+    return ok;
+}
@@ -0,0 +1,71 @@
+//=================================================================
+// The save game header file.
+//
+// Copyright 2023 Georgia Tech. All rights reserved.
+// The materials provided by the instructor in this course are for
+// the use of the students currently enrolled in the course.
+// Copyrighted course materials may not be further disseminated.
+// This file must NOT be made publicly available anywhere.
+//==================================================================
+
+#ifndef SAVE_H
+#define SAVE_H
+
+/*
+A save game is the player state plus, for every map that changed, only the
+tiles that differ from what its builder makes (see map_diff). Loading
+rebuilds each of those maps and replays the differences, so a save stays a
+few bytes per change however large the world is.
+
+Format, multi-byte values big-endian:
+  "SLB1"                          magic, bumped when the format changes
+  u16 player size, player bytes   copied as-is, so a save fits one build
+  u8 active map
+  u8 map count, then per map: u8 index, u32 diff size, diff
+  u16 sum of all the bytes before it
+
+save_encode and save_decode only touch memory; save_game and load_game add
+the file.
+*/
+
+// Where the save lives; LocalFileSystem is mounted as "local"
+#define SAVE_PATH "/local/SAVE.BIN"
+
+/**
+ * Encodes the player state (size bytes at player) and every changed map.
+ * Each map's diff is made once. Returns the save in a malloc'd buffer the
+ * caller frees and its size in *len, or NULL if a map cannot be encoded or
+ * there is no RAM for the save.
+ */
+unsigned char* save_encode(const void* player, int size, int* len);
+
+/**
+ * Checks a save from save_encode, then restores the player state into the
+ * size bytes at player, rebuilds and patches every map it lists, and
+ * activates its active map. Meant for a freshly registered set of maps.
+ * Returns 0, with nothing changed, if the save is corrupt or was made for a
+ * different player size or map registry. Also returns 0 if RAM runs out
+ * while patching maps; the player state is then untouched but some maps
+ * are patched, so register the maps again before starting a new game.
+ */
+int save_decode(const unsigned char* in, int len, void* player, int size);
+
+/**
+ * Encodes the game and writes it to SAVE_PATH. Returns the bytes written, or
+ * -1 on failure.
+ */
+int save_game(const void* player, int size);
+
+/**
+ * Deletes SAVE_PATH, so the next boot starts a new game. Returns 0 if there
+ * was no save to delete.
+ */
+int delete_save();
+
+/**
+ * Reads SAVE_PATH and decodes it as save_decode does. Returns 0 if there is
+ * no usable save.
+ */
+int load_game(void* player, int size);
+
+#endif // SAVE_H
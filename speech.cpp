@@ -13,6 +13,8 @@
 #include "globals.h"
 #include "hardware.h"
 #include "map.h"
+#include "graphics.h"
+#include "font.h"
 
 ///////////////////////////////
 //Static function declarations
@@ -65,9 +67,9 @@ void erase_speech_bubble()
 
 void draw_speech_line(const char* line, int which)
 {
-    // y = 13 for top and y = 14 for bottom
-    int y = which + 13;
-    uLCD.text_string((char *) line, 1, y, FONT_5X7, WHITE);
+    // Text rows 13 and 14 of 8 pixels, one character in
+    int y = (which + 13) * GLYPH_LINE;
+    draw_text(8, y, line, WHITE, BLACK, 1);
 }
 
 void speech_bubble_wait()
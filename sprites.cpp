@@ -0,0 +1,186 @@
+//=================================================================
+// The sprite data class file.
+//
+// Generated by tools/sprites.py from assets/sprites.txt. Do not edit;
+// change the asset file and run the tool again.
+//
+// Copyright 2023 Georgia Tech. All rights reserved.
+// The materials provided by the instructor in this course are for
+// the use of the students currently enrolled in the course.
+// Copyrighted course materials may not be further disseminated.
+// This file must NOT be made publicly available anywhere.
+//==================================================================
+
+#include "sprites.h"
+
+static const uint16_t PALETTE_0[3] = {0x0000, 0x7356, 0x0000};
+static const uint16_t PALETTE_1[4] = {0x0000, 0x7356, 0xFFE0, 0x0000};
+static const uint16_t PALETTE_2[4] = {0x0000, 0x07E0, 0xD343, 0x0000};
+static const uint16_t PALETTE_3[5] = {0x0000, 0x2C55, 0xD343, 0xE9C8, 0x0000};
+static const uint16_t PALETTE_4[4] = {0x0000, 0xE9C8, 0xFFE0, 0x0000};
+static const uint16_t PALETTE_5[4] = {0x0000, 0x5AEB, 0xBDF7, 0x0000};
+static const uint16_t PALETTE_6[2] = {0x0000, 0x5AEB};
+static const uint16_t PALETTE_7[3] = {0x0000, 0x5AEB, 0xD343};
+static const uint16_t PALETTE_8[8] = {0x0000, 0x001F, 0x13DF, 0x5881, 0x630C, 0xFFE0, 0xFFFF, 0x0000};
+static const uint16_t PALETTE_9[3] = {0x0000, 0x0018, 0x7BFF};
+static const uint16_t PALETTE_10[5] = {0x0000, 0xB000, 0xDA20, 0xDD80, 0xF801};
+static const uint16_t PALETTE_11[3] = {0x0000, 0x0333, 0xFFFF};
+
+const Sprite SPRITE_PLAYER =
+    {PALETTE_0, 3, 0x02, {
+        0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x11, 0x22, 0x22, 0x22, 0x22, 0x11, 0x11, 0x12, 0x22, 0x22,
+        0x21, 0x12, 0x21, 0x12, 0x22, 0x22, 0x22, 0x21, 0x11, 0x11, 0x22, 0x22, 0x22, 0x22, 0x11, 0x11,
+        0x12, 0x22, 0x21, 0x12, 0x21, 0x12, 0x22, 0x21, 0x11, 0x11, 0x12, 0x22, 0x21, 0x12, 0x21, 0x12,
+        0x22, 0x21, 0x11, 0x11, 0x11, 0x11, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x20,
+    }};
+
+const Sprite SPRITE_PLAYER_KEY =
+    {PALETTE_1, 4, 0x03, {
+        0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x11, 0x33, 0x33, 0x33, 0x33, 0x11, 0x11, 0x13, 0x33, 0x33,
+        0x31, 0x13, 0x31, 0x23, 0x33, 0x33, 0x33, 0x31, 0x11, 0x22, 0x33, 0x33, 0x33, 0x33, 0x11, 0x22,
+        0x23, 0x33, 0x31, 0x13, 0x32, 0x23, 0x33, 0x31, 0x11, 0x11, 0x23, 0x33, 0x31, 0x13, 0x31, 0x13,
+        0x33, 0x31, 0x11, 0x11, 0x11, 0x11, 0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x30,
+    }};
+
+const Sprite SPRITE_PLANT =
+    {PALETTE_2, 4, 0x03, {
+        0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x11, 0x11, 0x11, 0x11, 0x33, 0x31, 0x11, 0x11, 0x11, 0x11,
+        0x31, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x11, 0x11, 0x11, 0x11,
+        0x33, 0x33, 0x33, 0x22, 0x33, 0x33, 0x33, 0x33, 0x32, 0x23, 0x33, 0x33, 0x33, 0x33, 0x22, 0x33,
+        0x33, 0x33, 0x33, 0x22, 0x22, 0x23, 0x33, 0x33, 0x23, 0x32, 0x33, 0x23, 0x30,
+    }};
+
+const Sprite SPRITE_OTHER_PLANT =
+    {PALETTE_3, 5, 0x04, {
+        0x44, 0x44, 0x44, 0x44, 0x44, 0x44, 0x44, 0x11, 0x14, 0x44, 0x44, 0x44, 0x11, 0x11, 0x11, 0x44,
+        0x44, 0x11, 0x11, 0x11, 0x11, 0x44, 0x11, 0x11, 0x11, 0x11, 0x11, 0x14, 0x11, 0x11, 0x11, 0x11,
+        0x44, 0x44, 0x44, 0x22, 0x24, 0x44, 0x44, 0x44, 0x42, 0x22, 0x44, 0x44, 0x44, 0x44, 0x22, 0x24,
+        0x44, 0x44, 0x44, 0x33, 0x33, 0x34, 0x44, 0x44, 0x04, 0x40, 0x44, 0x04, 0x40,
+    }};
+
+const Sprite SPRITE_NPC =
+    {PALETTE_4, 4, 0x03, {
+        0x33, 0x33, 0x31, 0x33, 0x33, 0x33, 0x33, 0x31, 0x11, 0x33, 0x33, 0x33, 0x31, 0x11, 0x11, 0x33,
+        0x33, 0x31, 0x11, 0x11, 0x11, 0x33, 0x31, 0x11, 0x12, 0x11, 0x11, 0x31, 0x11, 0x12, 0x22, 0x11,
+        0x11, 0x31, 0x11, 0x12, 0x11, 0x11, 0x33, 0x31, 0x11, 0x11, 0x11, 0x33, 0x33, 0x31, 0x11, 0x11,
+        0x33, 0x33, 0x33, 0x31, 0x11, 0x33, 0x33, 0x33, 0x33, 0x31, 0x33, 0x33, 0x30,
+    }};
+
+const Sprite SPRITE_STAIRS =
+    {PALETTE_5, 4, 0x03, {
+        0x33, 0x33, 0x33, 0x33, 0x11, 0x13, 0x33, 0x33, 0x33, 0x31, 0x21, 0x33, 0x33, 0x33, 0x11, 0x11,
+        0x13, 0x33, 0x33, 0x31, 0x22, 0x21, 0x33, 0x33, 0x11, 0x11, 0x11, 0x13, 0x33, 0x31, 0x22, 0x22,
+        0x21, 0x33, 0x11, 0x11, 0x11, 0x11, 0x13, 0x31, 0x22, 0x22, 0x22, 0x21, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x22, 0x22, 0x22, 0x22, 0x21, 0x11, 0x11, 0x11, 0x11, 0x11, 0x10,
+    }};
+
+const Sprite SPRITE_CAVE1 =
+    {PALETTE_6, 2, 0xFF, {
+        0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x10,
+    }};
+
+const Sprite SPRITE_CAVE2 =
+    {PALETTE_6, 2, 0xFF, {
+        0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x10,
+    }};
+
+const Sprite SPRITE_CAVE3 =
+    {PALETTE_6, 2, 0xFF, {
+        0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x00, 0x01, 0x11, 0x11, 0x11, 0x10, 0x00, 0x11, 0x11, 0x11, 0x11, 0x00, 0x00,
+    }};
+
+const Sprite SPRITE_CAVE4 =
+    {PALETTE_6, 2, 0xFF, {
+        0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+        0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x10,
+    }};
+
+const Sprite SPRITE_MUD =
+    {PALETTE_7, 3, 0xFF, {
+        0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x11, 0x11, 0x22, 0x12, 0x21, 0x12, 0x11, 0x21, 0x12,
+        0x22, 0x12, 0x22, 0x11, 0x21, 0x12, 0x22, 0x11, 0x12, 0x11, 0x12, 0x22, 0x11, 0x21, 0x12, 0x22,
+        0x22, 0x22, 0x21, 0x11, 0x21, 0x11, 0x22, 0x21, 0x22, 0x21, 0x22, 0x12, 0x21, 0x21, 0x11, 0x21,
+        0x12, 0x22, 0x22, 0x22, 0x11, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x22, 0x20,
+    }};
+
+const Sprite SPRITE_BUZZ =
+    {PALETTE_8, 8, 0x07, {
+        0x77, 0x73, 0x37, 0x77, 0x77, 0x77, 0x73, 0x77, 0x37, 0x77, 0x77, 0x77, 0x75, 0x61, 0x47, 0x77,
+        0x77, 0x75, 0x51, 0x61, 0x66, 0x77, 0x75, 0x55, 0x11, 0x46, 0x66, 0x77, 0x75, 0x66, 0x56, 0x66,
+        0x67, 0x77, 0x75, 0x53, 0x32, 0x67, 0x72, 0x72, 0x33, 0x35, 0x32, 0x77, 0x72, 0x27, 0x75, 0x22,
+        0x77, 0x77, 0x77, 0x55, 0x33, 0x37, 0x77, 0x77, 0x77, 0x35, 0x57, 0x77, 0x70,
+    }};
+
+const Sprite SPRITE_WATER[2] = {
+    {PALETTE_9, 3, 0xFF, {
+        0x00, 0x00, 0x01, 0x10, 0x00, 0x00, 0x00, 0x01, 0x11, 0x10, 0x00, 0x00, 0x01, 0x11, 0x11, 0x10,
+        0x00, 0x01, 0x12, 0x22, 0x11, 0x10, 0x01, 0x11, 0x22, 0x22, 0x11, 0x00, 0x11, 0x22, 0x22, 0x21,
+        0x10, 0x01, 0x12, 0x22, 0x22, 0x11, 0x00, 0x11, 0x22, 0x22, 0x21, 0x10, 0x00, 0x12, 0x22, 0x22,
+        0x11, 0x00, 0x01, 0x12, 0x22, 0x21, 0x10, 0x00, 0x01, 0x11, 0x11, 0x00, 0x00,
+    }},
+    {PALETTE_9, 3, 0xFF, {
+        0x00, 0x00, 0x11, 0x00, 0x00, 0x00, 0x00, 0x11, 0x11, 0x00, 0x00, 0x00, 0x11, 0x11, 0x11, 0x00,
+        0x00, 0x11, 0x12, 0x22, 0x11, 0x00, 0x01, 0x12, 0x22, 0x21, 0x11, 0x00, 0x11, 0x22, 0x22, 0x21,
+        0x10, 0x01, 0x12, 0x22, 0x22, 0x11, 0x00, 0x11, 0x22, 0x22, 0x21, 0x10, 0x01, 0x12, 0x22, 0x22,
+        0x10, 0x00, 0x11, 0x22, 0x22, 0x11, 0x00, 0x00, 0x01, 0x11, 0x11, 0x00, 0x00,
+    }},
+};
+
+const Sprite SPRITE_FIRE[3] = {
+    {PALETTE_10, 5, 0xFF, {
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x40, 0x00, 0x00, 0x00, 0x00, 0x44, 0x44, 0x04, 0x44, 0x00,
+        0x04, 0x43, 0x40, 0x43, 0x44, 0x00, 0x04, 0x33, 0x43, 0x34, 0x40, 0x00, 0x43, 0x33, 0x33, 0x44,
+        0x40, 0x04, 0x22, 0x33, 0x34, 0x44, 0x44, 0x42, 0x22, 0x22, 0x42, 0x24, 0x41, 0x11, 0x22, 0x22,
+        0x24, 0x44, 0x11, 0x12, 0x21, 0x11, 0x40, 0x44, 0x41, 0x11, 0x11, 0x44, 0x40,
+    }},
+    {PALETTE_10, 5, 0xFF, {
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x44, 0x00, 0x04, 0x44, 0x04, 0x44,
+        0x40, 0x04, 0x43, 0x40, 0x43, 0x44, 0x00, 0x44, 0x33, 0x43, 0x34, 0x00, 0x44, 0x43, 0x33, 0x33,
+        0x40, 0x44, 0x44, 0x33, 0x32, 0x24, 0x04, 0x22, 0x42, 0x22, 0x22, 0x44, 0x44, 0x22, 0x22, 0x21,
+        0x11, 0x40, 0x41, 0x11, 0x22, 0x11, 0x14, 0x44, 0x41, 0x11, 0x11, 0x44, 0x40,
+    }},
+    {PALETTE_10, 5, 0xFF, {
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x04, 0x40, 0x00, 0x00, 0x00, 0x00, 0x44, 0x44, 0x04, 0x44, 0x00,
+        0x04, 0x42, 0x40, 0x42, 0x44, 0x00, 0x04, 0x22, 0x42, 0x24, 0x40, 0x00, 0x42, 0x22, 0x22, 0x44,
+        0x40, 0x04, 0x33, 0x22, 0x24, 0x44, 0x44, 0x43, 0x33, 0x33, 0x43, 0x34, 0x41, 0x11, 0x33, 0x33,
+        0x34, 0x44, 0x11, 0x13, 0x31, 0x11, 0x40, 0x44, 0x41, 0x11, 0x11, 0x44, 0x40,
+    }},
+};
+
+const Sprite SPRITE_EARTH[4] = {
+    {PALETTE_11, 3, 0xFF, {
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x22, 0x22, 0x20, 0x00,
+        0x00, 0x02, 0x12, 0x22, 0x22, 0x00, 0x02, 0x21, 0x11, 0x11, 0x22, 0x00, 0x22, 0x21, 0x11, 0x11,
+        0x20, 0x22, 0x12, 0x21, 0x11, 0x12, 0x02, 0x11, 0x12, 0x11, 0x11, 0x20, 0x21, 0x11, 0x21, 0x11,
+        0x22, 0x22, 0x11, 0x12, 0x11, 0x21, 0x11, 0x11, 0x11, 0x21, 0x22, 0x11, 0x10,
+    }},
+    {PALETTE_11, 3, 0xFF, {
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x22, 0x22, 0x20, 0x00,
+        0x00, 0x02, 0x21, 0x22, 0x22, 0x00, 0x02, 0x22, 0x11, 0x11, 0x12, 0x00, 0x22, 0x22, 0x11, 0x11,
+        0x10, 0x22, 0x21, 0x22, 0x11, 0x11, 0x02, 0x21, 0x11, 0x21, 0x11, 0x10, 0x22, 0x11, 0x12, 0x11,
+        0x12, 0x21, 0x21, 0x11, 0x21, 0x12, 0x11, 0x11, 0x11, 0x12, 0x12, 0x21, 0x10,
+    }},
+    {PALETTE_11, 3, 0xFF, {
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x22, 0x22, 0x20, 0x00,
+        0x00, 0x02, 0x22, 0x12, 0x22, 0x00, 0x02, 0x22, 0x21, 0x11, 0x11, 0x00, 0x12, 0x22, 0x21, 0x11,
+        0x10, 0x12, 0x22, 0x12, 0x21, 0x11, 0x01, 0x22, 0x11, 0x12, 0x11, 0x10, 0x22, 0x21, 0x11, 0x21,
+        0x11, 0x21, 0x12, 0x11, 0x12, 0x11, 0x21, 0x11, 0x11, 0x11, 0x21, 0x22, 0x10,
+    }},
+    {PALETTE_11, 3, 0xFF, {
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x22, 0x22, 0x20, 0x00,
+        0x00, 0x02, 0x22, 0x21, 0x22, 0x00, 0x01, 0x22, 0x22, 0x11, 0x11, 0x00, 0x11, 0x22, 0x22, 0x11,
+        0x10, 0x11, 0x22, 0x21, 0x22, 0x11, 0x01, 0x12, 0x21, 0x11, 0x21, 0x10, 0x22, 0x22, 0x11, 0x12,
+        0x11, 0x11, 0x11, 0x21, 0x11, 0x21, 0x12, 0x11, 0x11, 0x11, 0x12, 0x12, 0x20,
+    }},
+};
@@ -0,0 +1,58 @@
+//=================================================================
+// The sprite data header file.
+//
+// Generated by tools/sprites.py from assets/sprites.txt. Do not edit;
+// change the asset file and run the tool again.
+//
+// Copyright 2023 Georgia Tech. All rights reserved.
+// The materials provided by the instructor in this course are for
+// the use of the students currently enrolled in the course.
+// Copyrighted course materials may not be further disseminated.
+// This file must NOT be made publicly available anywhere.
+//==================================================================
+
+#ifndef SPRITES_H
+#define SPRITES_H
+
+#include <stdint.h>
+
+// Sprites are SPRITE_SIZE x SPRITE_SIZE pixels, row by row
+#define SPRITE_SIZE 11
+#define SPRITE_PIXELS (SPRITE_SIZE*SPRITE_SIZE)
+
+// Bytes of packed 4-bit pixels in a sprite
+#define SPRITE_BYTES ((SPRITE_PIXELS + 1) / 2)
+
+// Most colours in a sprite palette
+#define SPRITE_COLORS 16
+
+// Sprite.key of a sprite with no see-through pixels
+#define SPRITE_OPAQUE 0xFF
+
+/**
+ * An indexed sprite: each pixel is a 4-bit index into its palette.
+ */
+struct Sprite {
+    const uint16_t* palette;      // RGB565 colours; entry 0 is black
+    uint8_t colors;               // Entries in palette
+    uint8_t key;                  // Index of see-through pixels, or SPRITE_OPAQUE
+    uint8_t pixels[SPRITE_BYTES]; // Two pixels per byte, first one in the high nibble
+};
+
+extern const Sprite SPRITE_PLAYER;
+extern const Sprite SPRITE_PLAYER_KEY;
+extern const Sprite SPRITE_PLANT;
+extern const Sprite SPRITE_OTHER_PLANT;
+extern const Sprite SPRITE_NPC;
+extern const Sprite SPRITE_STAIRS;
+extern const Sprite SPRITE_CAVE1;
+extern const Sprite SPRITE_CAVE2;
+extern const Sprite SPRITE_CAVE3;
+extern const Sprite SPRITE_CAVE4;
+extern const Sprite SPRITE_MUD;
+extern const Sprite SPRITE_BUZZ;
+extern const Sprite SPRITE_WATER[2];
+extern const Sprite SPRITE_FIRE[3];
+extern const Sprite SPRITE_EARTH[4];
+
+#endif // SPRITES_H
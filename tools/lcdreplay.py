@@ -0,0 +1,181 @@
+#!/usr/bin/env python3
+"""Reports on and replays an LCD command stream recorded on the mbed.
+
+The console command "rec" records every byte the game sends to the uLCD
+into LCD.REC on the mbed drive (see uLCD_4DGL::record). This tool reads
+that file and prints the commands, bytes and time of the session, broken
+down by command, plus the time a transport would need to send it:
+
+    python3 tools/lcdreplay.py LCD.REC [--baud 3000000] [--ack-us 100]
+
+The transport is a model of the serial link: each byte costs 10 bits at
+the baud rate, bytes the driver sent with writeBYTE also wait --slow-us,
+and each command waits --ack-us for the screen's answer. It is given both
+with the recorded pacing and with every byte sent fast.
+
+With --port, the stream is also pushed through a real serial port (needs
+pyserial), e.g. to a screen on a USB serial adapter or to a stand-in on
+the host, waiting for the answer to each command, and the wall time is
+reported.
+"""
+
+import argparse
+import struct
+import sys
+import time
+
+MAGIC = b"ULCDREC1"
+REC_START = 0x01
+REC_SLOW = 0x02
+
+# First bytes of each command the driver sends (uLCD_4DGL*.cpp), to the
+# name of its opcode in uLCD_4DGL.h. writeCOMMAND puts 0xFF in front of the
+# opcode; TEXTSTRING, BLITCOM and VERSION go out after a 0x00 instead.
+NAMES = {
+    # uLCD_4DGL_main.cpp
+    b"\xff\xd7": "CLS",
+    b"\xff\x6e": "BCKGDCOLOR",
+    b"\xff\x7e": "TXTBCKGDCOLOR",
+    b"\xff\x68": "DISPCONTROL",
+    b"\xff\x66": "DISPPOWER",
+    b"\xff\x76": "SETVOLUME/TEXTBOLD",  # both are 0x76
+    b"\x00\x08": "VERSION",
+    b"\x0b": "BAUDRATE",  # its 0x00 goes out with the command before
+    # uLCD_4DGL_Graphics.cpp
+    b"\xff\xcd": "CIRCLE",
+    b"\xff\xcc": "FCIRCLE",
+    b"\xff\xc9": "TRIANGLE",
+    b"\xff\xd2": "LINE",
+    b"\xff\xcf": "RECTANGLE",
+    b"\xff\xce": "FRECTANGLE",
+    b"\xff\xcb": "PIXEL",
+    b"\xff\xca": "READPIXEL",
+    b"\xff\x63": "SCREENCOPY",
+    b"\xff\xd8": "PENSIZE",
+    b"\x00\x0a": "BLITCOM",
+    # uLCD_4DGL_Text.cpp
+    b"\xff\x7d": "SETFONT",
+    b"\xff\x77": "TEXTMODE",
+    b"\xff\x75": "TEXTITALIC",
+    b"\xff\x74": "TEXTINVERSE",
+    b"\xff\x73": "TEXTUNDERLINE",
+    b"\xff\x7c": "TEXTWIDTH",
+    b"\xff\x7b": "TEXTHEIGHT",
+    b"\xff\xfe": "TEXTCHAR",
+    b"\xff\xe4": "MOVECURSOR",
+    b"\xff\x7f": "color()",  # sent as a bare 0x7F, it has no name
+    b"\x00\x06": "TEXTSTRING",
+    # uLCD_4DGL_Media.cpp
+    b"\xff\xb1": "MINIT",
+    b"\xff\xb9": "SBADDRESS",
+    b"\xff\xb8": "SSADDRESS",
+    b"\xff\xb7": "READBYTE",
+    b"\xff\xb6": "READWORD",
+    b"\xff\xb5": "WRITEBYTE",
+    b"\xff\xb4": "WRITEWORD",
+    b"\xff\xb2": "FLUSHMEDIA",
+    b"\xff\xb3": "DISPLAYIMAGE",
+    b"\xff\xbb": "DISPLAYVIDEO",
+    b"\xff\xba": "DISPLAYFRAME",
+}
+
+
+def load(path):
+    """Returns the commands in a recording: a list of (time_us, data, slow),
+    where slow counts the bytes sent with writeBYTE."""
+    with open(path, "rb") as f:
+        raw = f.read()
+    if not raw.startswith(MAGIC):
+        sys.exit("%s: not an LCD recording" % path)
+    commands = []
+    pos = len(MAGIC)
+    while pos + 6 <= len(raw):
+        t, flags, n = struct.unpack_from("<IBB", raw, pos)
+        data = raw[pos + 6:pos + 6 + n]
+        pos += 6 + n
+        if len(data) < n:
+            break  # cut short, e.g. the mbed was reset while recording
+        if flags & REC_START or not commands:
+            commands.append([t, b"", 0])
+        commands[-1][1] += data
+        if flags & REC_SLOW:
+            commands[-1][2] += n
+    return [tuple(c) for c in commands]
+
+
+def name_of(data):
+    name = NAMES.get(data[:2]) or NAMES.get(data[:1])
+    return name or " ".join("%02X" % b for b in data[:2])
+
+
+def model_us(commands, baud, ack_us, slow_us, paced):
+    """Time in us the modelled transport takes to send every command."""
+    total = 0.0
+    for t, data, slow in commands:
+        total += len(data) * 10e6 / baud + ack_us
+        if paced:
+            total += slow * slow_us
+    return total
+
+
+def push(commands, port, baud, timeout):
+    """Sends the commands through a serial port, waiting for one answer byte
+    after each. Returns (seconds, commands that got no answer)."""
+    import serial  # pyserial, only needed here
+    link = serial.Serial(port, baud, timeout=timeout)
+    missed = 0
+    start = time.time()
+    for t, data, slow in commands:
+        link.reset_input_buffer()
+        link.write(data)
+        if not link.read(1):
+            missed += 1
+    elapsed = time.time() - start
+    link.close()
+    return elapsed, missed
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("recording")
+    parser.add_argument("--baud", type=int, default=3000000)
+    parser.add_argument("--ack-us", type=float, default=100.0,
+                        help="modelled wait for each command's answer")
+    parser.add_argument("--slow-us", type=float, default=500.0,
+                        help="writeBYTE's delay after each slow byte")
+    parser.add_argument("--port", help="serial port to push the stream through")
+    parser.add_argument("--timeout", type=float, default=0.5,
+                        help="seconds to wait for each answer with --port")
+    args = parser.parse_args()
+
+    commands = load(args.recording)
+    if not commands:
+        sys.exit("%s: no commands recorded" % args.recording)
+    nbytes = sum(len(d) for t, d, s in commands)
+    nslow = sum(s for t, d, s in commands)
+    span = commands[-1][0] - commands[0][0]
+    print("%d commands, %d bytes (%d slow), over %.1f ms recorded" %
+          (len(commands), nbytes, nslow, span / 1000.0))
+
+    kinds = {}
+    for t, data, slow in commands:
+        k = kinds.setdefault(name_of(data), [0, 0])
+        k[0] += 1
+        k[1] += len(data)
+    print("%-12s %8s %10s" % ("command", "count", "bytes"))
+    for name, (count, size) in sorted(kinds.items(), key=lambda kv: -kv[1][1]):
+        print("%-12s %8d %10d" % (name, count, size))
+
+    for paced in (True, False):
+        us = model_us(commands, args.baud, args.ack_us, args.slow_us, paced)
+        print("model at %d baud, %s: %.1f ms" %
+              (args.baud, "recorded pacing" if paced else "all fast", us / 1000.0))
+
+    if args.port:
+        seconds, missed = push(commands, args.port, args.baud, args.timeout)
+        print("pushed through %s: %.1f ms, %d commands unanswered" %
+              (args.port, seconds * 1000.0, missed))
+
+
+if __name__ == "__main__":
+    main()
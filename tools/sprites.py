@@ -0,0 +1,174 @@
+#!/usr/bin/env python3
+"""Compiles assets/sprites.txt into sprites.h and sprites.cpp.
+
+Every sprite becomes a const Sprite in flash: 4-bit palette indices, two
+pixels per byte, plus a palette of up to 16 RGB565 colours shared by all its
+frames (identical palettes are stored once). See-through "." pixels get a
+palette entry of their own, the sprite's key. Run from the repository root:
+
+    python3 tools/sprites.py
+"""
+
+import os
+import sys
+
+SIZE = 11
+KEY = "."     # see-through pixel
+OPAQUE = 0xFF  # key of a sprite with no see-through pixels
+ROOT = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..")
+
+BANNER = """//=================================================================
+// The sprite data {kind} file.
+//
+// Generated by tools/sprites.py from assets/sprites.txt. Do not edit;
+// change the asset file and run the tool again.
+//
+// Copyright 2023 Georgia Tech. All rights reserved.
+// The materials provided by the instructor in this course are for
+// the use of the students currently enrolled in the course.
+// Copyrighted course materials may not be further disseminated.
+// This file must NOT be made publicly available anywhere.
+//==================================================================
+"""
+
+
+def fail(lineno, msg):
+    sys.exit("assets/sprites.txt:%d: %s" % (lineno, msg))
+
+
+def rgb565(rgb):
+    """Packs 0xRRGGBB the way uLCD_4DGL::BLIT does."""
+    r = (rgb >> 19) & 0x1F
+    g = (rgb >> 10) & 0x3F
+    b = (rgb >> 3) & 0x1F
+    return (r << 11) | (g << 5) | b
+
+
+def parse(path):
+    """Returns (colors, sprites): char -> 0xRRGGBB, and a list of
+    (name, frames, rows, lineno) in file order; frames is 0 for a single
+    image."""
+    colors = {}
+    sprites = []
+    current = None
+    with open(path) as f:
+        for lineno, line in enumerate(f, 1):
+            if line.startswith("|"):
+                row = line.rstrip("\n")
+                if current is None:
+                    fail(lineno, "sprite row outside a sprite")
+                if len(row) != SIZE + 2 or not row.endswith("|"):
+                    fail(lineno, "rows must be %d characters between bars" % SIZE)
+                current[2].append(row[1:-1])
+                continue
+            words = line.split("#", 1)[0].split()
+            if not words:
+                continue
+            if words[0] == "color" and len(words) == 3 and len(words[1]) == 1:
+                colors[words[1]] = int(words[2], 16)
+            elif words[0] == "sprite" and len(words) in (2, 3):
+                frames = int(words[2]) if len(words) == 3 else 0
+                current = (words[1], frames, [], lineno)
+                sprites.append(current)
+            else:
+                fail(lineno, "unknown line: %s" % line.strip())
+    for name, frames, rows, lineno in sprites:
+        if len(rows) != SIZE * max(frames, 1):
+            fail(lineno, "sprite %s needs %d rows" % (name, SIZE * max(frames, 1)))
+    return colors, sprites
+
+
+MAX_COLORS = 16
+BYTES = (SIZE * SIZE + 1) // 2
+
+
+def palette_of(colors, rows, name, lineno):
+    """Returns (pal, key): the sorted RGB565 colours a sprite's rows use,
+    black first, and the index of the see-through entry, which is black and
+    comes last, or OPAQUE."""
+    pal = sorted(set(rgb565(colors.get(c, 0)) for row in rows for c in row if c != KEY) | {0})
+    key = OPAQUE
+    if any(KEY in row for row in rows):
+        key = len(pal)
+        pal.append(0)
+    if len(pal) > MAX_COLORS:
+        fail(lineno, "sprite %s uses %d colours, at most %d fit" % (name, len(pal), MAX_COLORS))
+    return pal, key
+
+
+def packed(colors, rows, pal, key):
+    """Packs one frame as 4-bit indices into pal, high nibble first."""
+    idx = [key if c == KEY else pal.index(rgb565(colors.get(c, 0)))
+           for row in rows for c in row]
+    idx.append(0)  # pad the odd last pixel
+    return [(idx[i] << 4) | idx[i + 1] for i in range(0, SIZE * SIZE, 2)]
+
+
+def format_bytes(data, indent):
+    lines = []
+    for i in range(0, len(data), 16):
+        lines.append(indent + ", ".join("0x%02X" % b for b in data[i:i + 16]) + ",")
+    return "\n".join(lines)
+
+
+def main():
+    colors, sprites = parse(os.path.join(ROOT, "assets", "sprites.txt"))
+
+    h = [BANNER.format(kind="header"), "#ifndef SPRITES_H", "#define SPRITES_H", "",
+         "#include <stdint.h>", "",
+         "// Sprites are SPRITE_SIZE x SPRITE_SIZE pixels, row by row",
+         "#define SPRITE_SIZE %d" % SIZE,
+         "#define SPRITE_PIXELS (SPRITE_SIZE*SPRITE_SIZE)", "",
+         "// Bytes of packed 4-bit pixels in a sprite",
+         "#define SPRITE_BYTES ((SPRITE_PIXELS + 1) / 2)", "",
+         "// Most colours in a sprite palette",
+         "#define SPRITE_COLORS %d" % MAX_COLORS, "",
+         "// Sprite.key of a sprite with no see-through pixels",
+         "#define SPRITE_OPAQUE 0x%02X" % OPAQUE, "",
+         "/**",
+         " * An indexed sprite: each pixel is a 4-bit index into its palette.",
+         " */",
+         "struct Sprite {",
+         "    const uint16_t* palette;      // RGB565 colours; entry 0 is black",
+         "    uint8_t colors;               // Entries in palette",
+         "    uint8_t key;                  // Index of see-through pixels, or SPRITE_OPAQUE",
+         "    uint8_t pixels[SPRITE_BYTES]; // Two pixels per byte, first one in the high nibble",
+         "};", ""]
+    c = [BANNER.format(kind="class"), '#include "sprites.h"', ""]
+
+    palettes = []  # distinct palettes, in order of first use
+    body = []
+    for name, frames, rows, lineno in sprites:
+        pal, key = palette_of(colors, rows, name, lineno)
+        if pal not in palettes:
+            palettes.append(pal)
+        pname = "PALETTE_%d" % palettes.index(pal)
+        images = [rows[f * SIZE:(f + 1) * SIZE] for f in range(max(frames, 1))]
+        if frames:
+            h.append("extern const Sprite SPRITE_%s[%d];" % (name, frames))
+            body.append("const Sprite SPRITE_%s[%d] = {" % (name, frames))
+        else:
+            h.append("extern const Sprite SPRITE_%s;" % name)
+            body.append("const Sprite SPRITE_%s =" % name)
+        for img in images:
+            body.append("    {%s, %d, 0x%02X, {\n%s\n    }}%s" % (pname, len(pal), key,
+                        format_bytes(packed(colors, img, pal, key), "        "),
+                        "," if frames else ";"))
+        if frames:
+            body.append("};")
+        body.append("")
+    for i, pal in enumerate(palettes):
+        c.append("static const uint16_t PALETTE_%d[%d] = {%s};" %
+                 (i, len(pal), ", ".join("0x%04X" % p for p in pal)))
+    c.append("")
+    c += body
+    h += ["", "#endif // SPRITES_H", ""]
+
+    with open(os.path.join(ROOT, "sprites.h"), "w") as f:
+        f.write("\n".join(h))
+    with open(os.path.join(ROOT, "sprites.cpp"), "w") as f:
+        f.write("\n".join(c))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,60 @@
+//=================================================================
+// The trigger class file.
+//
+// Copyright 2023 Georgia Tech. All rights reserved.
+// The materials provided by the instructor in this course are for
+// the use of the students currently enrolled in the course.
+// Copyrighted course materials may not be further disseminated.
+// This file must NOT be made publicly available anywhere.
+//==================================================================
+
+#include "trigger.h"
+#include "globals.h"
+
+/**
+ * The trigger registered for one item type.
+ */
+struct Trigger {
+    TriggerFunc handler;  // NULL if the type has no trigger
+    int reach;            // TRIGGER_HERE or TRIGGER_ADJACENT
+};
+
+static Trigger triggers[NUM_TYPES]; // Indexed by item type
+static int order[NUM_TYPES];        // Types with a trigger, by priority
+static int num_order;
+
+// Neighbourhood slots beside the player, in the order they are tried
+static const int ADJACENT_SLOTS[4] = {NB_S, NB_N, NB_E, NB_W};
+
+// Offsets of those slots from the player
+static const int ADJACENT_DX[4] = {0, 0, 1, -1};
+static const int ADJACENT_DY[4] = {1, -1, 0, 0};
+
+void trigger_register(int type, int reach, TriggerFunc f)
+{
+    if (triggers[type].handler == NULL) order[num_order++] = type;
+    triggers[type].handler = f;
+    triggers[type].reach = reach;
+}
+
+int trigger_fire(int x, int y)
+{
+    MapItem* nb[9];
+    map_neighbourhood(x, y, nb);
+
+    for (int k = 0; k < num_order; k++) {
+        int type = order[k];
+        Trigger* t = &triggers[type];
+        if (t->reach == TRIGGER_HERE) {
+            MapItem* item = nb[NB_HERE];
+            if (item && item->type == type) return t->handler(item, x, y);
+            continue;
+        }
+        for (int i = 0; i < 4; i++) {
+            MapItem* item = nb[ADJACENT_SLOTS[i]];
+            if (item && item->type == type)
+                return t->handler(item, x + ADJACENT_DX[i], y + ADJACENT_DY[i]);
+        }
+    }
+    return TRIGGER_NONE;
+}
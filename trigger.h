@@ -0,0 +1,52 @@
+//=================================================================
+// The trigger header file.
+//
+// Copyright 2023 Georgia Tech. All rights reserved.
+// The materials provided by the instructor in this course are for
+// the use of the students currently enrolled in the course.
+// Copyrighted course materials may not be further disseminated.
+// This file must NOT be made publicly available anywhere.
+//==================================================================
+
+#ifndef TRIGGER_H
+#define TRIGGER_H
+
+#include "map.h"
+
+/*
+What happens when the player presses the action button is looked up by the
+type of the MapItems around them. Each type has at most one handler, which
+fires either when the player stands on the item or when they stand next to
+it. The handler gets the item, so per-tile data such as the target of stairs
+(StairsData) drives what it does.
+*/
+
+// Where the player must be for a trigger to fire
+#define TRIGGER_HERE     0  // On the item's tile
+#define TRIGGER_ADJACENT 1  // On one of the four tiles beside it
+
+// Returned by trigger_fire when no trigger fired
+#define TRIGGER_NONE (-1)
+
+/**
+ * A trigger handler, called with the item and its location. Returns a result
+ * for the caller, e.g. an update_game result.
+ */
+typedef int (*TriggerFunc)(MapItem* item, int x, int y);
+
+/**
+ * Sets the handler for items of the given type, replacing any earlier one.
+ * Types registered first take priority in trigger_fire; replacing a handler
+ * keeps its type's place.
+ */
+void trigger_register(int type, int reach, TriggerFunc f);
+
+/**
+ * Fires the trigger for a player at (x,y). Types are tried in the order they
+ * were registered, and the first whose item is where its reach needs it, on
+ * the player's tile or beside it (south, north, east, west), fires. Returns
+ * the handler's result, or TRIGGER_NONE if nothing fired.
+ */
+int trigger_fire(int x, int y);
+
+#endif // TRIGGER_H
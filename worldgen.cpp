@@ -0,0 +1,180 @@
+//=================================================================
+// The world generator class file.
+//
+// Copyright 2023 Georgia Tech. All rights reserved.
+// The materials provided by the instructor in this course are for
+// the use of the students currently enrolled in the course.
+// Copyrighted course materials may not be further disseminated.
+// This file must NOT be made publicly available anywhere.
+//==================================================================
+
+#include "worldgen.h"
+#include "globals.h"
+#include "map.h"
+
+/**
+ * A placed room: its wall rectangle.
+ */
+typedef struct {
+    int x, y;   // Top left wall tile
+    int w, h;   // Size including walls
+} Room;
+
+static unsigned rng_state = 1;      // xorshift32 state
+static WorldParams builder_params;  // See worldgen_set_params
+static bool have_params;
+static int spawn_x = 1, spawn_y = 1; // See worldgen_spawn
+
+/**
+ * xorshift32: small, fast and the same on every platform.
+ */
+static unsigned wg_rand()
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+/**
+ * Returns a value in [lo, hi].
+ */
+static int wg_range(int lo, int hi)
+{
+    if (hi <= lo) return lo;
+    return lo + (int)(wg_rand() % (unsigned)(hi - lo + 1));
+}
+
+/**
+ * Returns true if room a, grown by one tile on every side, overlaps room b.
+ * The margin keeps a walkable lane between neighbouring rooms.
+ */
+static bool rooms_overlap(const Room* a, const Room* b)
+{
+    return a->x - 1 < b->x + b->w && b->x < a->x + a->w + 1 &&
+           a->y - 1 < b->y + b->h && b->y < a->y + a->h + 1;
+}
+
+/**
+ * Walls in a room, leaving a one-tile gap in the middle of its bottom wall.
+ */
+static void build_room(const Room* r)
+{
+    int gap = r->x + r->w / 2;
+    add_wall(r->x,          r->y,          HORIZONTAL, r->w);
+    add_wall(r->x,          r->y,          VERTICAL,   r->h);
+    add_wall(r->x + r->w-1, r->y,          VERTICAL,   r->h);
+    add_wall(r->x,          r->y + r->h-1, HORIZONTAL, gap - r->x);
+    add_wall(gap + 1,       r->y + r->h-1, HORIZONTAL, r->x + r->w - 1 - gap);
+}
+
+/**
+ * Lays an L-shaped mud trail from (x0,y0) to (x1,y1), horizontal leg first.
+ * Mud is ground, so it never replaces a wall.
+ */
+static void build_trail(int x0, int y0, int x1, int y1)
+{
+    int xa = x0 < x1 ? x0 : x1;
+    int ya = y0 < y1 ? y0 : y1;
+    add_mud(xa, y0, HORIZONTAL, abs(x1 - x0) + 1);
+    add_mud(x1, ya, VERTICAL,   abs(y1 - y0) + 1);
+}
+
+void worldgen_defaults(WorldParams* p, unsigned seed)
+{
+    int area = map_area();
+    p->seed = seed;
+    p->rooms = area / 400 + 1;          // about one room per 20x20 tiles
+    if (p->rooms > WG_MAX_ROOMS) p->rooms = WG_MAX_ROOMS;
+    p->room_min = 5;
+    p->room_max = 10;
+    p->plant_pct = 5;                   // init_main_map is about 5%
+    p->npcs = area / 2500 + 1;          // one per 50x50 tiles
+}
+
+void worldgen_build(const WorldParams* p)
+{
+    int w = map_width();
+    int h = map_height();
+    rng_state = p->seed ? p->seed : 1;
+
+    // Border
+    add_wall(0,   0,   HORIZONTAL, w);
+    add_wall(0,   h-1, HORIZONTAL, w);
+    add_wall(0,   0,   VERTICAL,   h);
+    add_wall(w-1, 0,   VERTICAL,   h);
+
+    // Rooms, by rejection sampling inside the border
+    Room rooms[WG_MAX_ROOMS];
+    int nrooms = 0;
+    int want = p->rooms < WG_MAX_ROOMS ? p->rooms : WG_MAX_ROOMS;
+    for (int tries = 0; nrooms < want && tries < 8 * want; tries++) {
+        Room r;
+        r.w = wg_range(p->room_min, p->room_max);
+        r.h = wg_range(p->room_min, p->room_max);
+        if (r.w > w - 4 || r.h > h - 4) continue; // map too small
+        r.x = wg_range(2, w - 2 - r.w);
+        r.y = wg_range(2, h - 3 - r.h); // leave the row below the gap open
+        bool ok = true;
+        for (int i = 0; i < nrooms && ok; i++) ok = !rooms_overlap(&r, &rooms[i]);
+        if (!ok) continue;
+        rooms[nrooms++] = r;
+        build_room(&r);
+    }
+
+    // Corridors: mud from each room's gap to the next room's gap
+    for (int i = 0; i + 1 < nrooms; i++) {
+        build_trail(rooms[i].x + rooms[i].w / 2,     rooms[i].y + rooms[i].h,
+                    rooms[i+1].x + rooms[i+1].w / 2, rooms[i+1].y + rooms[i+1].h);
+    }
+
+    // Scatter plants on open ground
+    int plants = (long) (w - 2) * (h - 2) * p->plant_pct / 100;
+    for (int i = 0; i < plants; i++) {
+        int x = wg_range(1, w - 2);
+        int y = wg_range(1, h - 2);
+        if (get_here(x, y)) continue; // keep walls, trails and other plants
+        if (wg_rand() & 1) add_plant(x, y);
+        else add_other_plant(x, y);
+    }
+
+    // Scatter NPCs on free walkable tiles
+    for (int i = 0, tries = 0; i < p->npcs && tries < 16 * p->npcs; tries++) {
+        int x = wg_range(1, w - 2);
+        int y = wg_range(1, h - 2);
+        if (get_layer(LAYER_OBJECT, x, y) || !map_walkable(x, y)) continue;
+        add_npc(x, y);
+        i++;
+    }
+
+    // Spawn on the first free walkable tile, scanning from the top left
+    spawn_x = spawn_y = 1;
+    for (int y = 1; y < h - 1; y++) {
+        for (int x = 1; x < w - 1; x++) {
+            if (get_layer(LAYER_OBJECT, x, y) || !map_walkable(x, y)) continue;
+            spawn_x = x;
+            spawn_y = y;
+            return;
+        }
+    }
+}
+
+void worldgen_spawn(int* x, int* y)
+{
+    *x = spawn_x;
+    *y = spawn_y;
+}
+
+void worldgen_set_params(const WorldParams* p)
+{
+    builder_params = *p;
+    have_params = true;
+}
+
+void worldgen_builder()
+{
+    WorldParams p;
+    if (have_params) p = builder_params;
+    else worldgen_defaults(&p, 1);
+    worldgen_build(&p);
+}
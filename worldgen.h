@@ -0,0 +1,70 @@
+//=================================================================
+// The world generator header file.
+//
+// Copyright 2023 Georgia Tech. All rights reserved.
+// The materials provided by the instructor in this course are for
+// the use of the students currently enrolled in the course.
+// Copyrighted course materials may not be further disseminated.
+// This file must NOT be made publicly available anywhere.
+//==================================================================
+
+#ifndef WORLDGEN_H
+#define WORLDGEN_H
+
+/*
+Seeded procedural worlds of any size, built through the map.h API. The same
+seed and parameters always give the same map, so a generated map can be
+registered with map_register like a hand-made one and rebuilt after it is
+evicted. Generated maps are the workload for benchmarking map storage and
+rendering at sizes far beyond the hand-made levels.
+
+A world is an open field with a wall border, scattered with walled rooms
+that each have a gap in their bottom wall. Mud trails join the rooms' gaps
+in the order they were placed, and plants and NPCs are scattered over the
+rest of the field.
+*/
+
+// Most rooms one world can hold
+#define WG_MAX_ROOMS 64
+
+/**
+ * Everything that shapes a generated world.
+ */
+typedef struct {
+    unsigned seed;      // PRNG seed; 0 is replaced by 1
+    int rooms;          // Rooms to try to place (at most WG_MAX_ROOMS)
+    int room_min;       // Smallest room side, walls included
+    int room_max;       // Largest room side, walls included
+    int plant_pct;      // Percent of the field that gets a plant
+    int npcs;           // NPCs to scatter in open tiles
+} WorldParams;
+
+/**
+ * Fills p with parameters that give the active map a density similar to the
+ * hand-made main map, scaled to its size.
+ */
+void worldgen_defaults(WorldParams* p, unsigned seed);
+
+/**
+ * Generates a world into the active map using p.
+ */
+void worldgen_build(const WorldParams* p);
+
+/**
+ * Returns in (x,y) a free walkable tile of the world worldgen_build last
+ * generated, for the player to start on.
+ */
+void worldgen_spawn(int* x, int* y);
+
+/**
+ * Sets the parameters used by worldgen_builder.
+ */
+void worldgen_set_params(const WorldParams* p);
+
+/**
+ * A MapBuilder that generates the active map from the parameters last given
+ * to worldgen_set_params, or worldgen_defaults(seed 1) if none were.
+ */
+void worldgen_builder();
+
+#endif // WORLDGEN_H